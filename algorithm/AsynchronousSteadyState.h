@@ -0,0 +1,361 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: AsynchronousSteadyState.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef ALGORITHM_ASYNCHRONOUSSTEADYSTATE_H_
+#define ALGORITHM_ASYNCHRONOUSSTEADYSTATE_H_
+
+#include "EvolutionaryAlgorithm.h"
+
+#include <atomic>
+#include <exception>
+#include <vector>
+
+/// @brief Provides an asynchronous steady-state EA without generational barriers.
+
+/// @details The first mu individuals of the population form an elite archive
+/// that is kept sorted by fitness. Each worker thread continuously selects parents
+/// uniformly from the archive, breeds one offspring by recombination and mutation,
+/// evaluates it and tries to insert it into the archive by replacing the worst
+/// member. Fast workers therefore never wait for slow evaluations.
+/// Every worker owns its random generator, variation operators and problem clone,
+/// only the archive is shared and guarded by a mutex. Evaluations are reserved before
+/// breeding, which makes the evaluation budget exact. Since the insertion order
+/// depends on the thread timing, runs with more than one worker are not reproducible.
+/// One generation corresponds to lambda evaluations for reporting and checkpointing.
+/// Evaluation processes, pipelined evaluation, thread pinning and batched problems,
+/// i.e. external evaluators and streamed datasets, are rejected by the constructor.
+
+/// @tparam E Evaluation Type
+/// @tparam G Genotype Type
+/// @tparam F Fitness Type
+template<class E, class G, class F>
+class AsynchronousSteadyState: public EvolutionaryAlgorithm<E, G, F> {
+private:
+	/// @brief Elements that are owned by a single worker thread.
+	struct Worker {
+		std::shared_ptr<Random> random;
+		std::shared_ptr<Species<G>> species;
+		std::shared_ptr<Mutation<G, F>> mutation;
+		std::shared_ptr<Recombination<G, F>> recombination;
+		std::shared_ptr<BlackBoxProblem<E, G, F>> problem;
+	};
+
+	int mu;
+	int lambda;
+	int num_workers;
+
+	bool neutral_genetic_drift;
+
+	std::mutex archive_mutex;
+	std::atomic<long long> reserved_evaluations;
+	std::atomic<bool> stop;
+
+	std::shared_ptr<Worker> create_worker(int worker);
+	void work(std::shared_ptr<Worker> worker);
+	std::shared_ptr<Individual<G, F>> select_parent(
+			std::shared_ptr<Worker> worker);
+	void insert(std::shared_ptr<Individual<G, F>> offspring);
+	void sort_archive();
+
+	void breed(int num_offspring) override;
+
+public:
+	AsynchronousSteadyState(std::shared_ptr<Composite<E, G, F>> p_composite);
+	virtual ~AsynchronousSteadyState() = default;
+
+	std::pair<int, F> evolve() override;
+
+};
+
+template<class E, class G, class F>
+AsynchronousSteadyState<E, G, F>::AsynchronousSteadyState(
+		std::shared_ptr<Composite<E, G, F>> p_composite) :
+		EvolutionaryAlgorithm<E, G, F>(p_composite) {
+	this->name = "async-steady-state";
+	mu = this->parameters->get_mu();
+	lambda = this->parameters->get_lambda();
+	num_workers = this->parameters->get_num_eval_threads();
+	neutral_genetic_drift = this->parameters->is_neutral_genetic_drift();
+	this->parameters->set_population_size(mu + lambda);
+	reserved_evaluations = 0;
+	stop = false;
+
+	// The workers evaluate their offspring one by one with their own problem
+	// clone, so the options of the shared evaluation path would be ignored
+	if (this->parameters->get_num_eval_processes() > 1) {
+		throw std::invalid_argument(
+				"Evaluation processes are not supported by the asynchronous steady-state EA!");
+	}
+
+	if (this->parameters->is_pipelined_evaluation()) {
+		throw std::invalid_argument(
+				"Pipelined evaluation is not supported by the asynchronous steady-state EA!");
+	}
+
+	if (this->parameters->is_pin_eval_threads()
+			|| this->parameters->is_numa_replicate_data()) {
+		throw std::invalid_argument(
+				"Thread pinning is not supported by the asynchronous steady-state EA!");
+	}
+
+	if (this->problem->is_batched()) {
+		throw std::invalid_argument(
+				"Batched problems are not supported by the asynchronous steady-state EA!");
+	}
+}
+
+/// @brief Creates the elements owned by a worker.
+/// @details The random generator of the worker is seeded with a seed
+/// derived from the seed of the composite.
+/// @param worker worker number
+/// @return shared pointer to the worker
+template<class E, class G, class F>
+std::shared_ptr<typename AsynchronousSteadyState<E, G, F>::Worker> AsynchronousSteadyState<
+		E, G, F>::create_worker(int worker) {
+
+	std::shared_ptr<Worker> w = std::make_shared<Worker>();
+
+	w->random = std::make_shared<Random>(
+			Random::derive_seed(this->random->get_global_seed(), worker + 1),
+			this->parameters);
+	w->species = std::make_shared<Species<G>>(w->random, this->parameters);
+	w->mutation = std::make_shared<Mutation<G, F>>(this->parameters, w->random,
+			w->species);
+	w->recombination = std::make_shared<Recombination<G, F>>(this->parameters,
+			w->random, w->species);
+	w->problem = std::shared_ptr<BlackBoxProblem<E, G, F>>(
+			this->problem->clone());
+
+	return w;
+}
+
+/// @brief Selects a parent uniformly from the elite archive.
+/// @param worker worker that performs the selection
+/// @return parent
+template<class E, class G, class F>
+std::shared_ptr<Individual<G, F>> AsynchronousSteadyState<E, G, F>::select_parent(
+		std::shared_ptr<Worker> worker) {
+	int index = worker->random->random_integer(0, this->mu - 1);
+	std::lock_guard<std::mutex> lock(this->archive_mutex);
+	return this->population->get_individual(index);
+}
+
+/// @brief Breeding is performed by the workers in the asynchronous EA.
+template<class E, class G, class F>
+void AsynchronousSteadyState<E, G, F>::breed(int num_offspring) {
+	throw std::logic_error(
+			"Breeding is done by the workers of the asynchronous steady-state EA!");
+}
+
+/// @brief Sorts the archive from best to worst fitness.
+template<class E, class G, class F>
+void AsynchronousSteadyState<E, G, F>::sort_archive() {
+
+	std::vector<std::shared_ptr<Individual<G, F>>> individuals;
+
+	for (int i = 0; i < this->population->size(); i++) {
+		individuals.push_back(this->population->get_individual(i));
+	}
+
+	std::stable_sort(individuals.begin(), individuals.end(),
+			[this](auto const ind1, auto const ind2) {
+				return this->fitness->is_better(ind1->get_fitness(),
+						ind2->get_fitness());
+			});
+
+	for (int i = 0; i < this->population->size(); i++) {
+		this->population->set_individual(individuals.at(i), i);
+	}
+}
+
+/// @brief Tries to insert an evaluated offspring into the elite archive.
+/// @details The offspring replaces the worst member of the archive if it is better
+/// or, in case NGD is enabled, equally good. The archive is kept sorted.
+/// Also advances the generation counter and triggers reporting and checkpointing.
+/// @param offspring evaluated offspring
+template<class E, class G, class F>
+void AsynchronousSteadyState<E, G, F>::insert(
+		std::shared_ptr<Individual<G, F>> offspring) {
+
+	std::lock_guard<std::mutex> lock(this->archive_mutex);
+
+	F fitness = offspring->get_fitness();
+	F worst = this->population->get_individual(this->mu - 1)->get_fitness();
+
+	bool is_better = this->fitness->is_better(fitness, worst);
+	bool is_equal = (fitness == worst);
+
+	if (is_better || (this->neutral_genetic_drift && is_equal)) {
+
+		// Move the offspring behind the last archive member that is not worse
+		int i = this->mu - 1;
+		while (i > 0
+				&& this->fitness->is_better(fitness,
+						this->population->get_individual(i - 1)->get_fitness())) {
+			this->population->set_individual(
+					this->population->get_individual(i - 1), i);
+			i--;
+		}
+		this->population->set_individual(offspring, i);
+	}
+
+	this->fitness_evaluations++;
+	this->best_fitness = this->population->get_individual(0)->get_fitness();
+
+	if (this->fitness->is_ideal(this->best_fitness)) {
+		this->stop = true;
+	}
+
+	// One generation corresponds to lambda evaluations
+	if (this->fitness_evaluations % this->lambda == 0) {
+		this->report(this->generation_number);
+		this->check_checkpoint();
+		this->generation_number++;
+	}
+}
+
+/// @brief Work loop of a worker thread.
+/// @details Reserves an evaluation from the budget, breeds one offspring
+/// from the archive, decodes and evaluates it with the own problem clone and
+/// inserts it into the archive.
+/// @param worker worker that performs the loop
+template<class E, class G, class F>
+void AsynchronousSteadyState<E, G, F>::work(std::shared_ptr<Worker> worker) {
+
+	while (!this->stop) {
+
+		// Reserve an evaluation to respect the budget exactly
+		long long reserved = this->reserved_evaluations++;
+		if (reserved >= this->max_fitness_evaluations) {
+			break;
+		}
+
+		Tracer::Span span(this->tracer.get(), "Individual", "evaluation", -1,
+				(int) reserved);
+
+		std::shared_ptr<Individual<G, F>> o1;
+		std::shared_ptr<Individual<G, F>> o2;
+
+		// The copies of the parents are allocated by the breeding
+		{
+			AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+					AllocCounters::BREED);
+			o1 = std::make_shared<Individual<G, F>>(this->select_parent(worker));
+			o2 = std::make_shared<Individual<G, F>>(this->select_parent(worker));
+		}
+
+		{
+			PerfCounters::Scope perf_scope(this->perf_counters.get(),
+					PerfCounters::BREED);
+			AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+					AllocCounters::BREED);
+
+			if (this->mu > 1) {
+				worker->recombination->crossover(o1, o2);
+			}
+
+			worker->mutation->mutate(o1);
+			o1->set_evaluated(false);
+		}
+
+		if (this->metrics != nullptr) {
+			this->metrics->count_lookup(o1->is_evaluated(), o1->is_decoded());
+		}
+
+		worker->problem->evaluate_individual(o1, &this->stop);
+		span.set_active_nodes(o1->get_active_nodes()->size());
+
+		if (this->metrics != nullptr && o1->is_evaluated()) {
+			this->metrics->count_evaluation(o1->get_active_nodes()->size());
+		}
+
+		// The evaluation has been cancelled since the ideal fitness has been reached
+		if (!o1->is_evaluated()) {
+			break;
+		}
+
+		this->insert(o1);
+	}
+}
+
+/// @brief Evolves the archive asynchronously with the configured number of workers.
+/// @details The initial population is evaluated as a whole and the best mu
+/// individuals form the initial archive. Its evaluations count against the budget.
+/// @return number of fitness evaluations, best fitness
+template<class E, class G, class F>
+std::pair<int, F> AsynchronousSteadyState<E, G, F>::evolve() {
+
+	this->best_fitness = this->fitness->worst_value();
+	this->is_ideal = false;
+	this->stop = false;
+
+	// The archive of a resumed job has been evaluated already and is not 
+	// evaluated again, but the insertion order of the workers is not reproduced
+	this->resumed = false;
+
+	// Evaluate the initial population
+	this->fitness_evaluations += this->evaluate();
+	this->reserved_evaluations = this->fitness_evaluations;
+
+	this->sort_archive();
+	this->best_fitness = this->population->get_individual(0)->get_fitness();
+	this->stop = this->fitness->is_ideal(this->best_fitness);
+
+	std::vector<std::shared_ptr<Worker>> workers;
+	for (int i = 0; i < this->num_workers; i++) {
+		workers.push_back(this->create_worker(i));
+	}
+
+	std::vector<std::thread> threads;
+	std::exception_ptr error = nullptr;
+	std::mutex error_mutex;
+
+	for (int i = 1; i < this->num_workers; i++) {
+		std::shared_ptr<Worker> worker = workers.at(i);
+		threads.push_back(std::thread([this, worker, &error, &error_mutex]() {
+			try {
+				this->work(worker);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(error_mutex);
+				error = std::current_exception();
+				this->stop = true;
+			}
+		}));
+	}
+
+	// The calling thread acts as the first worker
+	try {
+		this->work(workers.at(0));
+	} catch (...) {
+		std::lock_guard<std::mutex> lock(error_mutex);
+		error = std::current_exception();
+		this->stop = true;
+	}
+
+	for (auto &t : threads) {
+		t.join();
+	}
+
+	if (error != nullptr) {
+		std::rethrow_exception(error);
+	}
+
+	this->check_ideal(this->generation_number);
+
+	if (this->checkpointing) {
+		this->checkpoint->wait();
+	}
+
+	return std::pair<int, F> { this->fitness_evaluations, this->best_fitness };
+}
+
+#endif /* ALGORITHM_ASYNCHRONOUSSTEADYSTATE_H_ */
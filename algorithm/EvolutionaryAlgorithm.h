@@ -21,13 +21,27 @@
 #include "../problems/BlackBoxProblem.h"
 #include "../population/AbstractPopulation.h"
 #include "../checkpoint/Checkpoint.h"
+#include "../checkpoint/CheckpointState.h"
+#include "../checkpoint/Preemption.h"
+#include "../profiling/PhaseTimer.h"
+#include "../profiling/PerfCounters.h"
+#include "../profiling/AllocCounters.h"
+#include "../profiling/Tracer.h"
+#include "../profiling/MetricsServer.h"
 #include "../composite/Composite.h"
+#include "../concurrency/ThreadPool.h"
+#include "../concurrency/Topology.h"
+#include "../concurrency/ProcessFarm.h"
 
 #include <stdexcept>
 #include <memory>
 #include <thread>
 #include <cmath>
 #include <mutex>
+#include <atomic>
+#include <vector>
+#include <future>
+#include <algorithm>
 
 
 /// @brief Abstract base class to represent an evolutionary algorithm (EA) 
@@ -48,11 +62,13 @@ protected:
 	int report_interval;
 	int generation_number;
 	int fitness_evaluations;
-	int eval_chunk_size;
 
 	bool report_during_job;
 	bool is_ideal = false;
 	bool checkpointing;
+	bool pipelined_evaluation;
+	bool case_level_evaluation;
+	bool resumed;
 	int checkpoint_modulo;
 
 	F ideal_fitness;
@@ -78,17 +94,41 @@ protected:
 
 	std::shared_ptr<Composite<E, G, F>> composite;
 	std::vector<Individual<G, F>> offsprings;
+	std::vector<std::shared_ptr<BlackBoxProblem<E, G, F>>> eval_problems;
+	std::shared_ptr<ThreadPool> pool;
+	std::shared_ptr<ProcessFarm<E, G, F>> farm;
+	std::shared_ptr<PhaseTimer> timer;
+	std::shared_ptr<PerfCounters> perf_counters;
+	std::shared_ptr<AllocCounters> alloc_counters;
+	std::shared_ptr<Tracer> tracer;
+	std::shared_ptr<JobMetrics> metrics;
+
+	std::atomic<bool> cancelled;
+	std::atomic<int> performed_evaluations;
 
 
 	void report(int generation_number);
 	void check_ideal(int generation_number);
 	void check_checkpoint();
-	void decode();
-	void evaluate();
+	virtual CheckpointState<F> checkpoint_state() const;
+	int evaluate();
+	void evaluate_individual(std::shared_ptr<BlackBoxProblem<E, G, F>> p,
+			std::shared_ptr<Individual<G, F>> individual, int index,
+			ThreadPool *p_pool = nullptr);
 	void evaluate_concurrent();
-	void evaluate_chunk(std::vector<std::shared_ptr<Individual<G, F> > > chunk,
-			BlackBoxProblem<E, G, F> &p);
+	void evaluate_individuals(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals);
+	void init_eval_problems();
+	void evaluate_processes(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals);
+	void evaluate_batched(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals);
+	void count_lookups(
+			const std::vector<std::shared_ptr<Individual<G, F>>> &individuals);
+	void place_eval_threads();
 	void evaluate_consecutive();
+	int evaluate_batch(
+			std::vector<std::shared_ptr<Individual<G, F>>> &batch);
 
 	virtual void breed(int num_offspring) = 0;
 
@@ -100,6 +140,17 @@ public:
 	virtual const std::string& get_name() const;
 	int get_generation_number() const;
 	void set_generation_number(int p_generation_number);
+	std::shared_ptr<PhaseTimer> get_phase_timer() const;
+	std::shared_ptr<PerfCounters> get_perf_counters() const;
+	std::shared_ptr<AllocCounters> get_alloc_counters() const;
+	std::shared_ptr<Tracer> get_tracer() const;
+	std::shared_ptr<AbstractPopulation<G, F>> get_population() const;
+	void set_metrics(std::shared_ptr<JobMetrics> p_metrics);
+#ifdef CGP_EVAL_COUNTERS
+	std::shared_ptr<EvalCounters> get_eval_counters() const;
+#endif
+	virtual void restore(const CheckpointState<F> &state);
+	void init_eval_processes();
 
 };
 
@@ -136,13 +187,51 @@ EvolutionaryAlgorithm<E, G, F>::EvolutionaryAlgorithm(
 
 	report_interval = parameters->get_report_interval();
 	report_during_job = parameters->is_report_during_job();
+	pipelined_evaluation = parameters->is_pipelined_evaluation();
 
 	fitness_evaluations = 0;
 	generation_number = 1;
+	resumed = false;
+
+	cancelled = false;
+	performed_evaluations = 0;
+
+	// Parallelize over the fitness cases in case the individuals can not keep
+	// the evaluation threads busy but the shards of the dataset can
+	int num_eval_threads = parameters->get_num_eval_threads();
+	int num_offspring = parameters->get_num_offspring();
+	int num_shards = problem->get_num_shards();
+
+	case_level_evaluation = num_eval_threads > 1
+			&& std::min(num_shards, num_eval_threads)
+					> std::min(num_offspring, num_eval_threads);
+
+	// The evaluators of the problem clones are copied and share the timer
+	if (this->parameters->is_phase_timing()) {
+		timer = std::make_shared<PhaseTimer>();
+		evaluator->set_phase_timer(timer);
+		problem->get_evaluator()->set_phase_timer(timer);
+	}
 
-	eval_chunk_size = std::trunc(
-			this->parameters->get_population_size()
-					/ this->parameters->get_num_eval_threads());
+	if (this->parameters->is_perf_counters()) {
+		perf_counters = std::make_shared<PerfCounters>();
+		evaluator->set_perf_counters(perf_counters);
+		problem->get_evaluator()->set_perf_counters(perf_counters);
+	}
+
+	// The allocations are only counted if the hooks are compiled in
+#ifdef CGP_ALLOC_COUNTERS
+	alloc_counters = std::make_shared<AllocCounters>();
+	evaluator->set_alloc_counters(alloc_counters);
+	problem->get_evaluator()->set_alloc_counters(alloc_counters);
+#endif
+
+	if (this->parameters->is_write_tracefile()) {
+		tracer = std::make_shared<Tracer>();
+		evaluator->set_tracer(tracer);
+		problem->get_evaluator()->set_tracer(tracer);
+		checkpoint->set_tracer(tracer);
+	}
 
 	if (this->parameters->is_checkpointing()) {
 		checkpointing = this->parameters->is_checkpointing();
@@ -151,86 +240,354 @@ EvolutionaryAlgorithm<E, G, F>::EvolutionaryAlgorithm(
 		checkpointing = false;
 		checkpoint_modulo = -1;
 	}
+
+	// The evaluation processes are forked in the setup of a job, which would
+	// copy the state of the other job threads
+	if (parameters->get_num_eval_processes() > 1
+			&& parameters->get_num_job_threads() > 1
+			&& parameters->get_num_jobs() > 1) {
+		throw std::invalid_argument(
+				"Evaluation processes are not supported with several job threads!");
+	}
 }
 
 
-/// @brief Triggers the CGP decoding and starts the evaluation 
-/// either in a consecutive or concurrent fashion  
+/// @brief Starts the evaluation either in a consecutive or concurrent fashion
+/// @details The CGP decoding is done by the problem right before an individual
+/// is evaluated, so it runs within the evaluation threads.
+/// @return number of fitness evaluations that have been performed
 template<class E, class G, class F>
-void EvolutionaryAlgorithm<E, G, F>::evaluate() {
+int EvolutionaryAlgorithm<E, G, F>::evaluate() {
+	PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::EVALUATE);
+	Tracer::Span span(this->tracer.get(), "Evaluate", "phase",
+			this->generation_number);
 
-	this->decode();
+	this->performed_evaluations = 0;
 
-	if (parameters->get_num_eval_threads() == 1) {
+	if (parameters->get_num_eval_threads() == 1
+			&& parameters->get_num_eval_processes() == 1
+			&& !this->problem->is_batched()) {
 		this->evaluate_consecutive();
 	} else {
 		this->evaluate_concurrent();
 	}
+
+	return this->performed_evaluations;
 }
 
-/// @brief Decodes the individuals of the CGP by calling the decoder of the evaluator 
+/// @brief Evaluates an individual unless the evaluation has been cancelled. 
+/// @details An individual that reaches the ideal fitness cancels the evaluation. 
+/// The remaining individuals are then skipped at the next individual or fitness case 
+/// shard boundary and obtain the worst fitness value, so the job can terminate
+/// right away. Only completed evaluations are counted. 
+/// @param p problem that is used for the evaluation 
+/// @param individual individual to evaluate
+/// @param index index of the individual within the evaluated individuals
+/// @param p_pool thread pool for the evaluation of the fitness cases, if any
 template<class E, class G, class F>
-void EvolutionaryAlgorithm<E, G, F>::decode() {
-	std::shared_ptr<Individual<G, F>> individual;
+void EvolutionaryAlgorithm<E, G, F>::evaluate_individual(
+		std::shared_ptr<BlackBoxProblem<E, G, F>> p,
+		std::shared_ptr<Individual<G, F>> individual, int index,
+		ThreadPool *p_pool) {
+
+	if (this->metrics != nullptr) {
+		this->metrics->count_lookup(individual->is_evaluated(),
+				individual->is_decoded());
+	}
 
-	for (int i = 0; i < this->population->size(); i++) {
-		individual = this->population->get_individual(i);
-		this->evaluator->decode_path(individual);
+	if (individual->is_evaluated()) {
+#ifdef CGP_EVAL_COUNTERS
+		p->get_evaluator()->get_counters()->count_evaluation_skip();
+#endif
+		return;
+	}
+
+	Tracer::Span span(this->tracer.get(), "Individual", "evaluation",
+			this->generation_number, index);
+
+	if (!this->cancelled) {
+		if (p_pool != nullptr) {
+			p->evaluate_individual(individual, *p_pool, &this->cancelled);
+		} else {
+			p->evaluate_individual(individual, &this->cancelled);
+		}
+	}
+
+	span.set_active_nodes(individual->get_active_nodes()->size());
+
+	if (!individual->is_evaluated()) {
+		individual->set_fitness(this->fitness->worst_value());
+		return;
+	}
+
+	this->performed_evaluations++;
+
+	if (this->metrics != nullptr) {
+		this->metrics->count_evaluation(individual->get_active_nodes()->size());
+	}
+
+	if (this->fitness->is_ideal(individual->get_fitness())) {
+		this->cancelled = true;
 	}
 }
 
-/// @brief Evaluates the individuals by using conurrency 
-/// @details A thread pool is created by chunking the population 
-/// and evaluating each chunk in each thread. The thread pool is then
-/// synchronized. 
+/// @brief Creates the thread pool and one problem clone per evaluation thread. 
+/// @details The pool and the clones are kept for the whole run, each clone owns an 
+/// evaluator that is used for decoding and evaluation. 
 template<class E, class G, class F>
-void EvolutionaryAlgorithm<E, G, F>::evaluate_concurrent() {
+void EvolutionaryAlgorithm<E, G, F>::init_eval_problems() {
+	int num_eval_threads = parameters->get_num_eval_threads();
 
-	std::shared_ptr<Individual<G, F>> individual;
-	std::vector<std::thread> threads;
+	if (this->pool != nullptr) {
+		return;
+	}
 
-	int num_eval_threads = parameters->get_num_eval_threads();
-	int num_individuals = this->population->size();
+	this->pool = std::make_shared<ThreadPool>(num_eval_threads);
 
-	int start;
-	int n;
+	while ((int) this->eval_problems.size() < num_eval_threads) {
+		this->eval_problems.push_back(
+				std::shared_ptr<BlackBoxProblem<E, G, F>>(
+						this->problem->clone()));
+	}
 
-	for (int i = 0; i < num_eval_threads; i++) {
+	this->place_eval_threads();
+}
 
-		start = i * this->eval_chunk_size;
-		n = this->eval_chunk_size;
+/// @brief Pins the evaluation threads to CPUs and replicates the dataset per NUMA node.
+/// @details The workers are spread round-robin over the NUMA nodes and bound to a 
+/// CPU of their node. If replication is enabled and there is more than one node, 
+/// the first worker of each node copies the dataset on its own thread. Due to the 
+/// first-touch policy of the kernel, the pages of the copy are allocated on the 
+/// local node. The problem clone of each worker and the shards of the case-level 
+/// evaluation then read the replica of the node. Since the jobs of a concurrent 
+/// run would be pinned to the same CPUs, placement is only done for a single job.
+/// The calling thread acts as the first worker but is not owned by the pool. It is 
+/// only pinned while it copies the dataset and its affinity is restored afterwards, 
+/// since the threads it creates later, e.g. for the pipelined evaluation, the 
+/// checkpoint writer or the asynchronous workers, would inherit the single CPU.
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::place_eval_threads() {
 
-		if (i == num_eval_threads - 1 && (start + n) != num_individuals) {
-			n = num_individuals - start;
-		}
+	bool replicate = parameters->is_numa_replicate_data();
+	bool pin = parameters->is_pin_eval_threads() || replicate;
 
-		std::vector<std::shared_ptr<Individual<G, F> > > chunk;
-		BlackBoxProblem<E, G, F> *p = this->problem->clone();
+	if (!pin || parameters->get_num_job_threads() > 1) {
+		return;
+	}
+
+	Topology topology;
+
+	int num_workers = this->pool->size();
+	std::vector<int> cpus = topology.assign_cpus(num_workers);
+	std::vector<int> nodes(num_workers);
+
+	for (int i = 0; i < num_workers; i++) {
+		nodes.at(i) = topology.node_of_cpu(cpus.at(i));
+	}
+
+	std::shared_ptr<const Dataset<E>> dataset = this->problem->get_dataset();
+
+	replicate = replicate && topology.num_nodes() > 1 && dataset != nullptr;
+
+	std::vector<std::shared_ptr<const Dataset<E>>> node_datasets(
+			topology.num_nodes());
+
+	std::vector<int> caller_cpus = Topology::current_thread_cpus();
 
-		for (int i = start; i < start + n; i++) {
-			individual = this->population->get_individual(i);
-			chunk.push_back(individual);
+	this->pool->run_on_workers([&](int worker) {
+		Topology::pin_current_thread(cpus.at(worker));
+
+		int node = nodes.at(worker);
+		bool first_of_node = std::find(nodes.begin(), nodes.begin() + worker,
+				node) == nodes.begin() + worker;
+
+		if (replicate && first_of_node) {
+			node_datasets.at(node) = std::make_shared<Dataset<E>>(*dataset);
 		}
+	});
+
+	Topology::pin_current_thread(caller_cpus);
+
+	if (!replicate) {
+		return;
+	}
+
+	for (int i = 0; i < num_workers; i++) {
+		int node = nodes.at(i);
+		this->eval_problems.at(i)->set_data(node_datasets.at(node));
+		this->eval_problems.at(0)->set_worker_data(i, node_datasets.at(node));
+	}
+}
+
+/// @brief Evaluates the individuals of the population by using concurrency 
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::evaluate_concurrent() {
+
+	std::vector<std::shared_ptr<Individual<G, F>>> individuals;
+
+	for (int i = 0; i < this->population->size(); i++) {
+		individuals.push_back(this->population->get_individual(i));
+	}
+
+	this->evaluate_individuals(individuals);
+}
+
+/// @brief Evaluates a batch of individuals. 
+/// @details Used by the pipelined execution mode, where the calling thread runs 
+/// concurrently to the breeding of the next batch. Therefore, only the problem clones 
+/// are used for the evaluation.
+/// @param batch individuals to evaluate
+/// @return number of fitness evaluations that have been performed
+template<class E, class G, class F>
+int EvolutionaryAlgorithm<E, G, F>::evaluate_batch(
+		std::vector<std::shared_ptr<Individual<G, F>>> &batch) {
+	PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::EVALUATE);
+	Tracer::Span span(this->tracer.get(), "Evaluate", "phase",
+			this->generation_number);
+
+	this->performed_evaluations = 0;
+	this->evaluate_individuals(batch);
+	return this->performed_evaluations;
+}
+
+/// @brief Evaluates individuals with the workers of the thread pool. 
+/// @details Either the individuals are distributed over the workers, which evaluate
+/// them with their problem clones, or the individuals are evaluated one after
+/// another and the workers share the fitness cases of each individual. The mode is 
+/// chosen with respect to lambda, the size of the dataset and the number of threads. 
+/// If the problem evaluates in batches or evaluation processes are configured, 
+/// the individuals are passed to them instead.
+/// @param individuals individuals to evaluate
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::evaluate_individuals(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals) {
+
+	if (this->problem->is_batched()) {
+		this->evaluate_batched(individuals);
+		return;
+	}
+
+	if (parameters->get_num_eval_processes() > 1) {
+		this->evaluate_processes(individuals);
+		return;
+	}
+
+	this->init_eval_problems();
 
-		std::thread t = std::thread([=]() {
-			this->evaluate_chunk(chunk, *p);
+	if (this->case_level_evaluation) {
+		for (std::size_t i = 0; i < individuals.size(); i++) {
+			this->evaluate_individual(this->eval_problems.at(0),
+					individuals.at(i), i, this->pool.get());
+		}
+	} else {
+		this->pool->run(individuals.size(), [&](int task, int worker) {
+			this->evaluate_individual(this->eval_problems.at(worker),
+					individuals.at(task), task);
 		});
-		threads.push_back(std::move(t));
 	}
 
-	for (auto &t : threads) {
-		t.join();
+	if (this->timer != nullptr) {
+		this->timer->set_worker_seconds(this->pool->get_busy_seconds());
+	}
+}
+
+/// @brief Forks the evaluation processes of the job. 
+/// @details Called in the setup of the job before any of its helper threads is 
+/// started, since the workers are forked from a copy of the calling process. The 
+/// workers evaluate a problem clone, so they share the dataset that has been loaded. 
+/// Batched problems are evaluated as a whole and do not need the workers. 
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::init_eval_processes() {
+	if (this->farm != nullptr || this->parameters->get_num_eval_processes() <= 1
+			|| this->problem->is_batched()) {
+		return;
+	}
+
+	this->farm = std::make_shared<ProcessFarm<E, G, F>>(this->parameters,
+			this->random,
+			std::shared_ptr<BlackBoxProblem<E, G, F>>(this->problem->clone()),
+			this->parameters->get_num_eval_processes());
+}
+
+/// @brief Evaluates individuals with the forked evaluation processes. 
+/// @details The workers have been forked by init_eval_processes. Completed evaluations are counted and cancel the remaining ones once the ideal 
+/// fitness is reached, like in the threaded evaluation. 
+/// @param individuals individuals to evaluate
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::evaluate_processes(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals) {
+
+	this->count_lookups(individuals);
+
+	if (this->farm == nullptr) {
+		throw std::runtime_error("Evaluation processes have not been forked!");
+	}
+
+	this->farm->evaluate(individuals, &this->cancelled,
+			[this](std::shared_ptr<Individual<G, F>> individual) {
+				this->performed_evaluations++;
+				if (this->metrics != nullptr) {
+					this->metrics->count_evaluation(
+							individual->get_active_nodes()->size());
+				}
+				if (this->fitness->is_ideal(individual->get_fitness())) {
+					this->cancelled = true;
+				}
+			});
+
+	for (auto &individual : individuals) {
+		if (!individual->is_evaluated()) {
+			individual->set_fitness(this->fitness->worst_value());
+		}
+	}
+}
+
+/// @brief Passes the individuals as a whole to a problem that evaluates in batches. 
+/// @details A problem clone is used, since the calling thread may run concurrently 
+/// to the decoding of the next batch in the pipelined execution mode. The thread pool 
+/// is passed along, so that e.g. the shards of a streamed dataset are evaluated by 
+/// the evaluation threads. 
+/// @param individuals individuals to evaluate
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::evaluate_batched(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals) {
+
+	this->init_eval_problems();
+	this->count_lookups(individuals);
+
+	this->eval_problems.at(0)->evaluate_batch(individuals, *this->pool,
+			&this->cancelled,
+			[this](std::shared_ptr<Individual<G, F>> individual) {
+				this->performed_evaluations++;
+				if (this->metrics != nullptr) {
+					this->metrics->count_evaluation(
+							individual->get_active_nodes()->size());
+				}
+				if (this->fitness->is_ideal(individual->get_fitness())) {
+					this->cancelled = true;
+				}
+			});
+
+	for (auto &individual : individuals) {
+		if (!individual->is_evaluated()) {
+			individual->set_fitness(this->fitness->worst_value());
+		}
 	}
 }
 
-/// @brief Evaluates a chunk of individuals within a thread. 
+/// @brief Counts the individuals that are passed to the processes or a batched problem
+/// as lookups of the metrics, like evaluate_individual does for a single individual.
+/// @param individuals individuals to evaluate
 template<class E, class G, class F>
-void EvolutionaryAlgorithm<E, G, F>::evaluate_chunk(
-		std::vector<std::shared_ptr<Individual<G, F> > > chunk,
-		BlackBoxProblem<E, G, F> &p) {
+void EvolutionaryAlgorithm<E, G, F>::count_lookups(
+		const std::vector<std::shared_ptr<Individual<G, F>>> &individuals) {
+	if (this->metrics == nullptr) {
+		return;
+	}
 
-	for (auto it = chunk.begin(); it != chunk.end(); ++it) {
-		p.evaluate_individual(*it);
+	for (auto &individual : individuals) {
+		this->metrics->count_lookup(individual->is_evaluated(),
+				individual->is_decoded());
 	}
 }
 
@@ -240,7 +597,7 @@ void EvolutionaryAlgorithm<E, G, F>::evaluate_consecutive() {
 	std::shared_ptr<Individual<G, F>> individual;
 	for (int i = 0; i < this->population->size(); i++) {
 		individual = this->population->get_individual(i);
-		this->problem->evaluate_individual(individual);
+		this->evaluate_individual(this->problem, individual, i);
 	}
 }
 
@@ -249,17 +606,58 @@ template<class E, class G, class F>
 void EvolutionaryAlgorithm<E, G, F>::reset() {
 	this->generation_number = 1;
 	this->fitness_evaluations = 0;
+	this->resumed = false;
+	this->cancelled = false;
+
+	if (this->timer != nullptr) {
+		this->timer->reset();
+
+		if (this->pool != nullptr) {
+			this->pool->reset_busy_seconds();
+		}
+	}
+
+	if (this->perf_counters != nullptr) {
+		this->perf_counters->reset();
+	}
+
+	if (this->alloc_counters != nullptr) {
+		this->alloc_counters->reset();
+	}
+
+	if (this->tracer != nullptr) {
+		this->tracer->reset();
+	}
+
+#ifdef CGP_EVAL_COUNTERS
+	this->get_eval_counters()->reset();
+#endif
 }
 
 /// @brief Reports the current status of the EA 
 /// (genration number and best fitness found so far). 
 template<class E, class G, class F>
 void EvolutionaryAlgorithm<E, G, F>::report(int generation_number) {
+	PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::REPORT);
+	Tracer::Span span(this->tracer.get(), "Report", "phase",
+			this->generation_number);
+
+	if (this->metrics != nullptr) {
+		this->metrics->publish(this->generation_number,
+				this->fitness_evaluations, this->best_fitness);
+	}
 
 	if (this->report_during_job) {
 		if (generation_number % this->report_interval == 0) {
 			std::cout << "Generation # " << this->generation_number
-					<< " :: Best Fitness: " << this->best_fitness << std::endl;
+					<< " :: Best Fitness: " << this->best_fitness
+#ifdef CGP_EVAL_COUNTERS
+					<< this->get_eval_counters()->to_string(false)
+#endif
+					<< (this->alloc_counters != nullptr ?
+							this->alloc_counters->interval_to_string(
+									this->generation_number) :
+							"") << std::endl;
 		}
 	}
 }
@@ -278,12 +676,42 @@ void EvolutionaryAlgorithm<E, G, F>::check_ideal(int generation_number) {
 }
 
 /// @brief Checks whether a new checkpoing should be triggered. 
-/// @details Checkpoint interval is predefined by a checkpoint modulo. 
+/// @details Checkpoint interval is predefined by a checkpoint modulo. The checkpoint 
+/// is written in the background while the evolution continues. In case the termination 
+/// of the process has been requested, a checkpoint is written immediately, regardless 
+/// of the modulo and whether checkpointing is enabled, and the job is stopped.
 template<class E, class G, class F>
 void EvolutionaryAlgorithm<E, G, F>::check_checkpoint() {
+	PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::CHECKPOINT);
+
+	if (Preemption::is_requested()) {
+		if (!this->checkpoint->is_initialized()) {
+			this->checkpoint->init(this->checkpoint->get_job());
+		}
+
+		std::string checkpoint_file = this->checkpoint->write(this->population,
+				this->constants, this->checkpoint_state());
+
+		if (this->metrics != nullptr) {
+			this->metrics->count_checkpoint();
+		}
+
+		throw PreemptedException(checkpoint_file);
+	}
+
 	if (this->checkpointing) {
 		if (this->generation_number % this->checkpoint_modulo == 0) {
-			this->checkpoint->write(this->population, this->constants, this->generation_number);
+			Tracer::Span span(this->tracer.get(), "Checkpoint", "phase",
+					this->generation_number);
+			// The metrics record the checkpoint once it has been written
+			std::shared_ptr<JobMetrics> job_metrics = this->metrics;
+
+			this->checkpoint->write_async(this->population, this->constants,
+					this->checkpoint_state(), [job_metrics]() {
+						if (job_metrics != nullptr) {
+							job_metrics->count_checkpoint();
+						}
+					});
 
 			if (this->report_during_job) {
 				std::cout << "Checkpoint written at generation # "
@@ -293,6 +721,44 @@ void EvolutionaryAlgorithm<E, G, F>::check_checkpoint() {
 	}
 }
 
+/// @brief Returns the state of the EA that is stored in a checkpoint.
+/// @details Checkpoints are taken after the selection of a generation, so the 
+/// state describes the EA right before the offspring are bred.
+/// @return state of the EA and the random generator
+template<class E, class G, class F>
+CheckpointState<F> EvolutionaryAlgorithm<E, G, F>::checkpoint_state() const {
+	CheckpointState<F> state;
+	state.generation_number = this->generation_number;
+	state.fitness_evaluations = this->fitness_evaluations;
+	state.best_fitness = this->best_fitness;
+	state.random_state = this->random->get_state();
+	state.exact = true;
+	return state;
+}
+
+/// @brief Restores the state of the EA from a checkpoint.
+/// @details In case the state is exact, the counters and the best fitness are restored and 
+/// the next call of evolve continues right after the selection of the restored generation, 
+/// so the job proceeds as if it had not been interrupted. Otherwise, only the generation 
+/// number is restored and the restored population is evaluated again. 
+/// @param state state of the EA at the time of the checkpoint
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::restore(const CheckpointState<F> &state) {
+	this->generation_number = state.generation_number;
+
+	if (state.exact) {
+		this->fitness_evaluations = state.fitness_evaluations;
+		this->best_fitness = state.best_fitness;
+		this->is_ideal = this->fitness->is_ideal(state.best_fitness);
+		this->resumed = true;
+
+		// The active nodes are not stored but used by the crossover operators
+		for (int i = 0; i < this->population->size(); i++) {
+			this->evaluator->decode_path(this->population->get_individual(i));
+		}
+	}
+}
+
 // Getter and setter of EA class
 // ------------------------------------------------------------------------------------------
 
@@ -312,6 +778,58 @@ void EvolutionaryAlgorithm<E, G, F>::set_generation_number(int p_generation_numb
 	generation_number = p_generation_number;
 }
 
+/// @brief Returns the timer of the phases of the evolutionary loop.
+/// @return shared pointer to the timer or nullptr if phase timing is disabled
+template<class E, class G, class F>
+std::shared_ptr<PhaseTimer> EvolutionaryAlgorithm<E, G, F>::get_phase_timer() const {
+	return this->timer;
+}
+
+/// @brief Returns the hardware performance counters of the decode, evaluate and breed phases.
+/// @return shared pointer to the counters or nullptr if sampling is disabled
+template<class E, class G, class F>
+std::shared_ptr<PerfCounters> EvolutionaryAlgorithm<E, G, F>::get_perf_counters() const {
+	return this->perf_counters;
+}
+
+/// @brief Returns the allocation counters of the phases of the job.
+/// @return shared pointer to the counters or nullptr if the hooks are not compiled in
+template<class E, class G, class F>
+std::shared_ptr<AllocCounters> EvolutionaryAlgorithm<E, G, F>::get_alloc_counters() const {
+	return this->alloc_counters;
+}
+
+/// @brief Returns the tracer that records the timeline of the job.
+/// @return shared pointer to the tracer or nullptr if tracing is disabled
+template<class E, class G, class F>
+std::shared_ptr<Tracer> EvolutionaryAlgorithm<E, G, F>::get_tracer() const {
+	return this->tracer;
+}
+
+/// @brief Returns the population the algorithm evolves.
+/// @return shared pointer to the population
+template<class E, class G, class F>
+std::shared_ptr<AbstractPopulation<G, F>> EvolutionaryAlgorithm<E, G, F>::get_population() const {
+	return this->population;
+}
+
+/// @brief Sets the metrics the progress of the job is published to.
+/// @param p_metrics shared pointer to the metrics or nullptr to disable publishing
+template<class E, class G, class F>
+void EvolutionaryAlgorithm<E, G, F>::set_metrics(
+		std::shared_ptr<JobMetrics> p_metrics) {
+	this->metrics = p_metrics;
+}
+
+#ifdef CGP_EVAL_COUNTERS
+/// @brief Returns the evaluation counters, which are shared by the problem clones.
+/// @return shared pointer to the counters
+template<class E, class G, class F>
+std::shared_ptr<EvalCounters> EvolutionaryAlgorithm<E, G, F>::get_eval_counters() const {
+	return this->problem->get_evaluator()->get_counters();
+}
+#endif
+
 // ------------------------------------------------------------------------------------------
 
 
@@ -34,8 +34,18 @@ private:
 	int mu;
 	int lambda;
 
+	// Batch that is bred while the current batch is evaluated in the pipelined mode
+	std::vector<std::shared_ptr<Individual<G, F>>> next_batch;
+	bool pending_batch;
+
 	int select_parent();
 	void breed(int num_offspring) override;
+	std::vector<std::shared_ptr<Individual<G, F>>> breed_batch(
+			int num_offspring);
+	void select(int evaluations);
+	std::pair<int, F> evolve_pipelined();
+	CheckpointState<F> checkpoint_state() const override;
+	void restore(const CheckpointState<F> &state) override;
 public:
 	MuPlusLambda(std::shared_ptr<Composite<E, G, F>> p_composite);
 	virtual ~MuPlusLambda() = default;
@@ -51,6 +61,7 @@ MuPlusLambda<E, G, F>::MuPlusLambda(
 	this->name = "mu-plus-lambda";
 	mu = this->parameters->get_mu();
 	lambda = this->parameters->get_lambda();
+	pending_batch = false;
 	this->parameters->set_population_size(mu + lambda);
 }
 
@@ -89,23 +100,59 @@ void MuPlusLambda<E, G, F>::breed(int num_offspring) {
 	}
 }
 
-/// @brief Evolves the population in the mu+lambda fashion 
-/// @return number of fitness evaluations, best fitness 
+/// @brief Breeds and decodes a batch of offspring from the current parents 
+/// without placing them into the population. 
+/// @param num_offspring number of offspring 
+/// @return decoded offspring 
 template<class E, class G, class F>
-std::pair<int, F> MuPlusLambda<E, G, F>::evolve() {
+std::vector<std::shared_ptr<Individual<G, F>>> MuPlusLambda<E, G, F>::breed_batch(
+		int num_offspring) {
 
-	this->best_fitness = this->fitness->worst_value();
-	this->is_ideal = false;
+	std::vector<std::shared_ptr<Individual<G, F>>> batch;
 
-	while (this->generation_number <= this->max_generations && !this->is_ideal) {
+	for (int i = 0; i < num_offspring; i++) {
+
+		int idx1 = this->select_parent();
+		int idx2 = this->select_parent();
+
+		std::shared_ptr<Individual<G, F>> o1 = std::make_shared<
+				Individual<G, F>>(this->population->get_individual(idx1));
+		std::shared_ptr<Individual<G, F>> o2 = std::make_shared<
+				Individual<G, F>>(this->population->get_individual(idx2));
+
+		this->recombination->crossover(o1, o2);
+
+		this->mutation->mutate(o1);
+		o1->set_evaluated(false);
+
+		// Decode here to overlap with the evaluation of the current batch
+		this->evaluator->decode_path(o1);
 
+		batch.push_back(o1);
+	}
+
+	return batch;
+}
+
+/// @brief Performs the selection on the evaluated population and 
+/// triggers reporting, ideal fitness check and checkpointing. 
+/// @details In the pipelined mode, the next batch has already been bred at this point. 
+/// It is placed into the offspring slots, which only hold discarded individuals after 
+/// the sort, so a checkpoint contains the batch and the job can be resumed exactly. 
+/// @param evaluations number of fitness evaluations that have been performed
+template<class E, class G, class F>
+void MuPlusLambda<E, G, F>::select(int evaluations) {
 
-		// Trigger the evaluation process
-		this->evaluate();
+	// Increase the number of fitness evaluations by the number
+	// that has been used in the evaluation procedure
+	this->fitness_evaluations += evaluations;
 
-		// Increase the number of fitness evaluations by the number
-		// that has been used in the evaluation procedure
-		this->fitness_evaluations += this->lambda;
+	{
+		PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::SELECT);
+		Tracer::Span span(this->tracer.get(), "Select", "phase",
+				this->generation_number);
+		AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+				AllocCounters::SELECT);
 
 		// Sort population for the selection process
 		this->population->sort();
@@ -113,23 +160,187 @@ std::pair<int, F> MuPlusLambda<E, G, F>::evolve() {
 		// Obtain best fitness from the sorted population
 		this->best_fitness = this->population->get_individual(0)->get_fitness();
 
-		// Trigger reporting intermediate result results
-		this->report(this->generation_number);
+		for (std::size_t i = 0; i < this->next_batch.size(); i++) {
+			this->population->set_individual(this->next_batch.at(i),
+					this->mu + i);
+		}
+	}
+
+	// Trigger reporting intermediate result results
+	this->report(this->generation_number);
+
+	// Check for ideal fitness
+	this->check_ideal(this->generation_number);
+
+	// Check for checkpoint modulo 
+	this->check_checkpoint();
+}
+
+/// @brief Evolves the population in the mu+lambda fashion 
+/// @return number of fitness evaluations, best fitness 
+template<class E, class G, class F>
+std::pair<int, F> MuPlusLambda<E, G, F>::evolve() {
+
+	if (this->pipelined_evaluation) {
+		return this->evolve_pipelined();
+	}
+
+	if (!this->resumed) {
+		this->best_fitness = this->fitness->worst_value();
+		this->is_ideal = false;
+	}
+
+	while (this->generation_number <= this->max_generations && !this->is_ideal) {
+		Tracer::Span generation_span(this->tracer.get(), "Generation",
+				"generation", this->generation_number);
 
-		// Check for ideal fitness
-		this->check_ideal(this->generation_number);
+		// A resumed job continues right after the selection of the checkpoint
+		if (this->resumed) {
+			this->resumed = false;
+		} else {
+			// Trigger the evaluation process
+			int evaluations = this->evaluate();
 
-		// Check for checkpoint modulo 
-		this->check_checkpoint();
+			// Sort, report and check for the ideal fitness and checkpoint
+			this->select(evaluations);
+		}
 
 		// Breed lambda offspring 
-		this->breed(lambda);
+		{
+			PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::BREED);
+			Tracer::Span span(this->tracer.get(), "Breed", "phase",
+					this->generation_number);
+			PerfCounters::Scope perf_scope(this->perf_counters.get(),
+					PerfCounters::BREED);
+			AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+					AllocCounters::BREED);
+			this->breed(lambda);
+		}
+
+		this->generation_number++;
+
+	}
+
+	if (this->checkpointing) {
+		this->checkpoint->wait();
+	}
+
+	return std::pair<int, F> { this->fitness_evaluations, this->best_fitness };
+}
+
+/// @brief Evolves the population in the pipelined mu+lambda fashion
+/// @details While the offspring of generation g are evaluated by a background task, 
+/// the offspring of generation g+1 are bred and decoded from the parents that 
+/// have been selected in generation g-1. Parent selection is therefore delayed 
+/// by one generation, which allows to use more threads than lambda. A resumed job 
+/// evaluates the batch that has been stored in the checkpoint instead of breeding it. 
+/// @return number of fitness evaluations, best fitness 
+template<class E, class G, class F>
+std::pair<int, F> MuPlusLambda<E, G, F>::evolve_pipelined() {
+
+	// The first generation is evaluated as a whole, unless the job is resumed
+	// after the selection of a checkpoint
+	if (this->resumed) {
+		this->resumed = false;
+		this->generation_number++;
+	} else {
+		this->best_fitness = this->fitness->worst_value();
+		this->is_ideal = false;
+
+		if (this->generation_number <= this->max_generations) {
+			this->select(this->evaluate());
+			this->generation_number++;
+		}
+	}
+
+	std::vector<std::shared_ptr<Individual<G, F>>> batch;
+
+	if (this->pending_batch) {
+		this->pending_batch = false;
+
+		for (int i = 0; i < this->lambda; i++) {
+			batch.push_back(this->population->get_individual(this->mu + i));
+		}
+	} else if (!this->is_ideal
+			&& this->generation_number <= this->max_generations) {
+		PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::BREED);
+		Tracer::Span span(this->tracer.get(), "Breed", "phase",
+				this->generation_number);
+		PerfCounters::Scope perf_scope(this->perf_counters.get(),
+				PerfCounters::BREED);
+		AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+				AllocCounters::BREED);
+		batch = this->breed_batch(this->lambda);
+	}
+
+	while (this->generation_number <= this->max_generations && !this->is_ideal) {
+		Tracer::Span generation_span(this->tracer.get(), "Generation",
+				"generation", this->generation_number);
+
+		// Evaluate the current batch in the background
+		std::future<int> evaluation = std::async(std::launch::async,
+				[this, &batch]() {
+					return this->evaluate_batch(batch);
+				});
+
+		// Breed and decode the next batch meanwhile
+		if (this->generation_number < this->max_generations) {
+			try {
+				PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::BREED);
+				Tracer::Span span(this->tracer.get(), "Breed", "phase",
+						this->generation_number);
+				PerfCounters::Scope perf_scope(this->perf_counters.get(),
+						PerfCounters::BREED);
+				AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+						AllocCounters::BREED);
+				this->next_batch = this->breed_batch(this->lambda);
+			} catch (...) {
+				evaluation.wait();
+				throw;
+			}
+		}
+
+		int evaluations = evaluation.get();
+
+		for (int i = 0; i < this->lambda; i++) {
+			this->population->set_individual(batch.at(i), this->mu + i);
+		}
+
+		// Sort, report and check for the ideal fitness and checkpoint
+		this->select(evaluations);
+
+		batch = std::move(this->next_batch);
+		this->next_batch.clear();
 
 		this->generation_number++;
+	}
 
+	if (this->checkpointing) {
+		this->checkpoint->wait();
 	}
 
 	return std::pair<int, F> { this->fitness_evaluations, this->best_fitness };
 }
 
+/// @brief Returns the state of the EA including whether a bred batch is pending.
+/// @return state of the EA and the random generator
+template<class E, class G, class F>
+CheckpointState<F> MuPlusLambda<E, G, F>::checkpoint_state() const {
+	CheckpointState<F> state = EvolutionaryAlgorithm<E, G, F>::checkpoint_state();
+	state.pending_batch = !this->next_batch.empty();
+	return state;
+}
+
+/// @brief Restores the state of the EA including whether a bred batch is pending.
+/// @details The pending batch is only evaluated in the pipelined mode, otherwise the 
+/// offspring slots are overwritten by the breeding. 
+/// @param state state of the EA at the time of the checkpoint
+template<class E, class G, class F>
+void MuPlusLambda<E, G, F>::restore(const CheckpointState<F> &state) {
+	EvolutionaryAlgorithm<E, G, F>::restore(state);
+
+	this->pending_batch = state.exact && state.pending_batch
+			&& this->pipelined_evaluation;
+}
+
 #endif /* ALGORITHM_MUPLUSLAMBDA_H_ */
@@ -45,12 +45,14 @@ private:
 	void create_fitness_map();
 
 	void breed(int num_offspring) override;
+	CheckpointState<F> checkpoint_state() const override;
 
 public:
 	OnePlusLambda(std::shared_ptr<Composite<E, G, F>> p_composite);
 	virtual ~OnePlusLambda() = default;
 
 	std::pair<int, F> evolve() override;
+	void restore(const CheckpointState<F> &state) override;
 
 };
 
@@ -165,39 +167,62 @@ void OnePlusLambda<E, G, F>::breed(int num_offspring) {
 template<class E, class G, class F>
 std::pair<int, F> OnePlusLambda<E, G, F>::evolve() {
 
-	this->best_fitness = this->fitness->worst_value();
-	this->is_ideal = false;
+	if (!this->resumed) {
+		this->best_fitness = this->fitness->worst_value();
+		this->is_ideal = false;
 
-	if (this->generation_number == 0) {
-		this->parent_index = -1;
+		if (this->generation_number == 0) {
+			this->parent_index = -1;
+		}
 	}
 
 	while (this->generation_number <= this->max_generations && !this->is_ideal) {
+		Tracer::Span generation_span(this->tracer.get(), "Generation",
+				"generation", this->generation_number);
 
-		this->evaluate();
+		// A resumed job continues right after the selection of the checkpoint
+		if (this->resumed) {
+			this->resumed = false;
+		} else {
+			// Increase the number of fitness evaluations by the number
+			// that has been used in the evaluation procedure
+			this->fitness_evaluations += this->evaluate();
 
-		// Increase the number of fitness evaluations by the number
-		// that has been used in the evaluation procedure
-		this->fitness_evaluations += this->lambda;
+			// Obtain parent with or without considering NGD
+			{
+				PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::SELECT);
+				Tracer::Span span(this->tracer.get(), "Select", "phase",
+						this->generation_number);
+				AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+						AllocCounters::SELECT);
+				this->parent_index = this->select_parent();
+			}
 
-		// Obtain parent with or without considering NGD
-		this->parent_index = this->select_parent();
+			this->parent = this->population->get_individual(this->parent_index);
 
-		this->parent = this->population->get_individual(this->parent_index);
+			// Obtain best fitness from the sorted population
+			this->best_fitness = parent->get_fitness();
 
-		// Obtain best fitness from the sorted population
-		this->best_fitness = parent->get_fitness();
+			this->report(this->generation_number);
 
-		this->report(this->generation_number);
+			// Check for ideal fitness
+			this->check_ideal(this->generation_number);
 
-		// Check for ideal fitness
-		this->check_ideal(this->generation_number);
-
-		// Check for checkpoint modulo 
-		this->check_checkpoint();
+			// Check for checkpoint modulo 
+			this->check_checkpoint();
+		}
 
 		// Breed lambda offspring 
-		this->breed(lambda);
+		{
+			PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::BREED);
+			Tracer::Span span(this->tracer.get(), "Breed", "phase",
+					this->generation_number);
+			PerfCounters::Scope perf_scope(this->perf_counters.get(),
+					PerfCounters::BREED);
+			AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+					AllocCounters::BREED);
+			this->breed(lambda);
+		}
 
 		// Reset parent index for the next generation
 		this->parent_index = 0;
@@ -206,7 +231,32 @@ std::pair<int, F> OnePlusLambda<E, G, F>::evolve() {
 
 	}
 
+	if (this->checkpointing) {
+		this->checkpoint->wait();
+	}
+
 	return std::pair<int, F> { this->fitness_evaluations, this->best_fitness };
 }
 
+/// @brief Returns the state of the EA including the index of the selected parent.
+/// @return state of the EA and the random generator
+template<class E, class G, class F>
+CheckpointState<F> OnePlusLambda<E, G, F>::checkpoint_state() const {
+	CheckpointState<F> state = EvolutionaryAlgorithm<E, G, F>::checkpoint_state();
+	state.parent_index = this->parent_index;
+	return state;
+}
+
+/// @brief Restores the state of the EA including the index of the selected parent.
+/// @param state state of the EA at the time of the checkpoint
+template<class E, class G, class F>
+void OnePlusLambda<E, G, F>::restore(const CheckpointState<F> &state) {
+	EvolutionaryAlgorithm<E, G, F>::restore(state);
+
+	if (state.exact) {
+		this->parent_index = state.parent_index;
+		this->parent = this->population->get_individual(this->parent_index);
+	}
+}
+
 #endif /* ALGORITHM_ONEPLUSLAMBDA_H_ */
@@ -0,0 +1,454 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: cgp-bench.cpp
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+// Microbenchmarks of the kernels of CGP++: decoding of the active path, iterative
+// and recursive evaluation, the mutation and crossover operators and the sorting
+// of the population. The kernels are run on the benchmark files for each
+// combination of genome size and function set with a fixed seed, so the workload
+// is the same from run to run. The results are written as JSON to the standard
+// output with the median time per operation over the repetitions, the node
+// evaluations per second of the evaluation kernels and the heap allocations per
+// operation.
+//
+// usage: cgp-bench <options> [DATAFILE ...]
+//
+// -n <list>     comma-separated numbers of function nodes (default 50,500,2000)
+// -f <list>     comma-separated sizes of the function set (default 2,4)
+// -r <value>    timed repetitions per benchmark (default 5)
+// -s <value>    seed (default 1234)
+// -p <value>    point mutation rate (default from the parameter file)
+// -P <file>     parameter file (default data/parfiles/cgp.params)
+//
+// Example: ./cgp-bench -n 100,1000 data/plufiles/add3.plu data/datfiles/koza1.dat > bench.json
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <stdexcept>
+
+#include <getopt.h>
+
+#include "../representation/Individual.h"
+#include "../initializer/LogicSynthesisInitializer.h"
+#include "../initializer/SymbolicRegressionInitializer.h"
+#include "../benchmark/DatasetCache.h"
+#include "../variation/mutation/ProbabilisticPoint.h"
+#include "../variation/mutation/SingleActiveGene.h"
+#include "../variation/mutation/Inversion.h"
+#include "../variation/mutation/Duplication.h"
+#include "../variation/crossover/BlockCrossover.h"
+#include "../variation/crossover/DiscreteCrossover.h"
+#include "../profiling/AllocHooks.h"
+
+/// @brief Number of individuals the kernels are run on.
+static const int POOL_SIZE = 16;
+
+/// @brief Result of a benchmark.
+struct Result {
+	std::string name;
+	long long ops;
+	double ns_per_op;
+	double ns_per_op_min;
+	double node_evals_per_s;
+	double allocs_per_op;
+	double bytes_per_op;
+};
+
+/// @brief Configuration of the benchmarks of a data file.
+struct Config {
+	std::string datafile;
+	std::string parfile;
+	int num_nodes;
+	int num_functions;
+	int repetitions;
+	long long seed;
+	float mutation_rate;
+};
+
+/// @brief Runs a kernel once as warm-up and then for a number of repetitions.
+/// @details The setup is called before each run and is not timed. The time per
+/// operation is the median over the repetitions, the allocations are averaged.
+/// @param name name of the benchmark
+/// @param ops number of operations per run
+/// @param node_evals node evaluations per run, zero if the kernel evaluates no nodes
+/// @param repetitions number of timed runs
+/// @param setup function that prepares a run
+/// @param run function that performs the operations of a run
+/// @return result of the benchmark
+Result measure(const std::string &name, long long ops, long long node_evals,
+		int repetitions, const std::function<void()> &setup,
+		const std::function<void()> &run) {
+
+	std::vector<double> times;
+	long long allocations = 0;
+	long long bytes = 0;
+
+	for (int r = 0; r <= repetitions; r++) {
+		setup();
+
+		AllocCounters::Sample before = AllocCounters::read();
+		auto start = std::chrono::steady_clock::now();
+
+		run();
+
+		auto end = std::chrono::steady_clock::now();
+
+		// The first run warms up the caches and is not recorded
+		if (r > 0) {
+			times.push_back(
+					std::chrono::duration<double, std::nano>(end - start).count());
+			AllocCounters::Sample after = AllocCounters::read();
+			allocations += after.allocations - before.allocations;
+			bytes += after.bytes - before.bytes;
+		}
+	}
+
+	std::sort(times.begin(), times.end());
+	double median = times.at(times.size() / 2);
+
+	Result result;
+	result.name = name;
+	result.ops = ops;
+	result.ns_per_op = median / ops;
+	result.ns_per_op_min = times.front() / ops;
+	result.node_evals_per_s = median > 0.0 ? node_evals / (median * 1e-9) : 0.0;
+	result.allocs_per_op = (double) allocations / repetitions / ops;
+	result.bytes_per_op = (double) bytes / repetitions / ops;
+
+	return result;
+}
+
+/// @brief Runs the benchmarks of a data file for one genome size and function set.
+/// @tparam E Evaluation type
+/// @tparam G Genome type
+/// @tparam F Fitness type
+/// @param initializer initializer of the problem domain of the data file
+/// @param config configuration of the benchmarks
+/// @return results of the benchmarks
+template<class E, class G, class F>
+std::vector<Result> run_benchmarks(
+		std::shared_ptr<BlackBoxInitializer<E, G, F>> initializer,
+		const Config &config) {
+
+	std::shared_ptr<Dataset<E>> dataset = DatasetCache<E>::read(
+			config.datafile);
+
+	// Initialize the parameters as the main program does, the data is read
+	// without the dataset cache to leave the data directory untouched
+	// ---------------------------------------------------------------------------------------
+	initializer->init_parfile_parameters(config.parfile);
+
+	std::shared_ptr<Parameters> parameters = initializer->get_parameters();
+	parameters->set_num_variables(dataset->get_num_inputs());
+	parameters->set_num_outputs(dataset->get_num_outputs());
+	parameters->set_generate_random_seed(false);
+	parameters->set_evaluate_expression(false);
+
+	initializer->init_comandline_parameters(-1, config.num_nodes, -1, 0, -1,
+			config.num_functions, -1, 1, POOL_SIZE - 1, config.mutation_rate, -1,
+			-1, -1, config.seed, -1, -1, -1, -1, -1, config.num_nodes);
+
+	initializer->init_functions();
+	initializer->init_composite();
+
+	std::shared_ptr<Composite<E, G, F>> composite =
+			initializer->get_composite();
+	std::shared_ptr<Evaluator<E, G, F>> evaluator = composite->get_evaluator();
+	std::shared_ptr<StaticPopulation<G, F>> population =
+			composite->get_population();
+	std::shared_ptr<Random> random = composite->get_random();
+	std::shared_ptr<Species<G>> species = composite->get_species();
+
+	// Inputs and outputs of the fitness cases
+	// ---------------------------------------------------------------------------------------
+	int num_cases = dataset->get_num_instances();
+	std::vector<std::shared_ptr<std::vector<E>>> inputs;
+
+	for (int i = 0; i < num_cases; i++) {
+		std::shared_ptr<std::vector<E>> input = std::make_shared<
+				std::vector<E>>(dataset->get_num_inputs());
+		for (int j = 0; j < dataset->get_num_inputs(); j++) {
+			(*input)[j] = dataset->input(i, j);
+		}
+		inputs.push_back(input);
+	}
+
+	std::shared_ptr<std::vector<E>> outputs = std::make_shared<
+			std::vector<E>>();
+
+	// The kernels work on copies of the decoded initial population
+	// ---------------------------------------------------------------------------------------
+	std::vector<std::shared_ptr<Individual<G, F>>> originals;
+	std::vector<std::shared_ptr<Individual<G, F>>> pool(POOL_SIZE);
+	long long active_nodes = 0;
+
+	for (int i = 0; i < POOL_SIZE; i++) {
+		std::shared_ptr<Individual<G, F>> individual =
+				population->get_individual(i);
+		evaluator->decode_path(individual);
+		active_nodes += individual->num_active_nodes();
+		originals.push_back(individual);
+	}
+
+	auto copy_pool = [&]() {
+		for (int i = 0; i < POOL_SIZE; i++) {
+			pool[i] = std::make_shared<Individual<G, F>>(originals[i]);
+		}
+	};
+
+	int repetitions = config.repetitions;
+	std::vector<Result> results;
+
+	// Decoding and evaluation, an operation is one individual
+	// ---------------------------------------------------------------------------------------
+	results.push_back(measure("decode_path", POOL_SIZE, 0, repetitions,
+			copy_pool, [&]() {
+				for (auto &individual : pool) {
+					evaluator->decode_path(individual);
+				}
+			}));
+
+	auto evaluate = [&](bool recursive) {
+		for (auto &individual : pool) {
+			for (auto &input : inputs) {
+				outputs->clear();
+				if (recursive) {
+					evaluator->evaluate_recursive(individual, input, outputs);
+				} else {
+					evaluator->evaluate_iterative(individual, input, outputs);
+				}
+			}
+		}
+	};
+
+	results.push_back(measure("evaluate_iterative", POOL_SIZE,
+			active_nodes * num_cases, repetitions, copy_pool, [&]() {
+				evaluate(false);
+			}));
+
+	results.push_back(measure("evaluate_recursive", POOL_SIZE,
+			active_nodes * num_cases, repetitions, copy_pool, [&]() {
+				evaluate(true);
+			}));
+
+	// Mutation and crossover, an operation is one variation. The individuals are
+	// not decoded again between the variations.
+	// ---------------------------------------------------------------------------------------
+	const int rounds = 64;
+
+	std::vector<std::pair<std::string, std::shared_ptr<UnaryOperator<G, F>>>> mutations =
+			{ { "probabilistic_point", std::make_shared<ProbabilisticPoint<G, F>>(
+					parameters, random, species) }, { "single_active_gene",
+					std::make_shared<SingleActiveGene<G, F>>(parameters, random,
+							species) }, { "inversion", std::make_shared<
+					Inversion<G, F>>(parameters, random, species) }, {
+					"duplication", std::make_shared<Duplication<G, F>>(
+							parameters, random, species) } };
+
+	for (auto &mutation : mutations) {
+		results.push_back(measure(mutation.first, POOL_SIZE * rounds, 0,
+				repetitions, copy_pool, [&]() {
+					for (int r = 0; r < rounds; r++) {
+						for (auto &individual : pool) {
+							mutation.second->variate(individual);
+						}
+					}
+				}));
+	}
+
+	std::vector<std::pair<std::string, std::shared_ptr<BinaryOperator<G, F>>>> crossovers =
+			{ { "block_crossover", std::make_shared<BlockCrossover<G, F>>(
+					parameters, random, species) }, { "discrete_crossover",
+					std::make_shared<DiscreteCrossover<G, F>>(parameters, random,
+							species) } };
+
+	for (auto &crossover : crossovers) {
+		results.push_back(measure(crossover.first, POOL_SIZE / 2 * rounds, 0,
+				repetitions, copy_pool, [&]() {
+					for (int r = 0; r < rounds; r++) {
+						for (int i = 0; i < POOL_SIZE; i += 2) {
+							crossover.second->variate(pool[i], pool[i + 1]);
+						}
+					}
+				}));
+	}
+
+	// Sorting of the population, an operation is one sort of fitness values
+	// that have been drawn at random
+	// ---------------------------------------------------------------------------------------
+	std::vector<F> fitness_values(population->size() * rounds);
+	for (auto &f : fitness_values) {
+		f = random->random_integer(0, 1000);
+	}
+
+	results.push_back(measure("population_sort", rounds, 0, repetitions,
+			[]() {
+			}, [&]() {
+				for (int r = 0; r < rounds; r++) {
+					for (int i = 0; i < population->size(); i++) {
+						population->get_individual(i)->set_fitness(
+								fitness_values[r * population->size() + i]);
+					}
+					population->sort();
+				}
+			}));
+
+	return results;
+}
+
+/// @brief Escapes a string for JSON.
+std::string quote(const std::string &s) {
+	std::string quoted = "\"";
+	for (char c : s) {
+		if (c == '"' || c == '\\') {
+			quoted += '\\';
+		}
+		quoted += c;
+	}
+	return quoted + "\"";
+}
+
+/// @brief Parses a comma-separated list of integers.
+std::vector<int> parse_list(const std::string &s) {
+	std::vector<int> values;
+	std::stringstream ss(s);
+	std::string item;
+	while (std::getline(ss, item, ',')) {
+		values.push_back(std::stoi(item));
+	}
+	return values;
+}
+
+void usage() {
+	std::cerr << "usage: cgp-bench <options> [DATAFILE ...]" << std::endl;
+	std::cerr << "-n <list>     comma-separated numbers of function nodes"
+			<< std::endl;
+	std::cerr << "-f <list>     comma-separated sizes of the function set"
+			<< std::endl;
+	std::cerr << "-r <value>    timed repetitions per benchmark" << std::endl;
+	std::cerr << "-s <value>    seed" << std::endl;
+	std::cerr << "-p <value>    point mutation rate" << std::endl;
+	std::cerr << "-P <file>     parameter file" << std::endl;
+	exit(1);
+}
+
+int main(int argc, char **argv) {
+
+	std::vector<int> node_counts = { 50, 500, 2000 };
+	std::vector<int> function_counts = { 2, 4 };
+
+	Config config;
+	config.parfile = "data/parfiles/cgp.params";
+	config.repetitions = 5;
+	config.seed = 1234;
+	config.mutation_rate = -1.0f;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "n:f:r:s:p:P:")) != -1) {
+		switch (opt) {
+		case 'n':
+			node_counts = parse_list(optarg);
+			break;
+		case 'f':
+			function_counts = parse_list(optarg);
+			break;
+		case 'r':
+			config.repetitions = std::max(1, atoi(optarg));
+			break;
+		case 's':
+			config.seed = atol(optarg);
+			break;
+		case 'p':
+			config.mutation_rate = atof(optarg);
+			break;
+		case 'P':
+			config.parfile = optarg;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	std::vector<std::string> datafiles;
+	for (int i = optind; i < argc; i++) {
+		datafiles.push_back(argv[i]);
+	}
+
+	if (datafiles.empty()) {
+		datafiles = { "data/plufiles/add3.plu", "data/plufiles/epar8.plu",
+				"data/plufiles/mult3.plu", "data/datfiles/koza1.dat",
+				"data/datfiles/pagie-training.dat" };
+	}
+
+	std::cout << "{\"seed\":" << config.seed << ",\"repetitions\":"
+			<< config.repetitions << ",\"parfile\":" << quote(config.parfile)
+			<< ",\"benchmarks\":[";
+
+	bool first = true;
+
+	for (const std::string &datafile : datafiles) {
+		for (int num_nodes : node_counts) {
+			for (int num_functions : function_counts) {
+				config.datafile = datafile;
+				config.num_nodes = num_nodes;
+				config.num_functions = num_functions;
+
+				std::vector<Result> results;
+
+				if (datafile.find(".plu") != std::string::npos) {
+					results = run_benchmarks<long, int, int>(
+							std::make_shared<
+									LogicSynthesisInitializer<long, int, int>>(
+									datafile), config);
+				} else if (datafile.find(".dat") != std::string::npos) {
+					results = run_benchmarks<float, int, float>(
+							std::make_shared<
+									SymbolicRegressionInitializer<float, int,
+											float>>(datafile), config);
+				} else {
+					throw std::invalid_argument("Datatype is not supported!");
+				}
+
+				for (const Result &result : results) {
+					std::cout << (first ? "\n" : ",\n") << "{\"name\":"
+							<< quote(result.name) << ",\"datafile\":"
+							<< quote(datafile) << ",\"num_function_nodes\":"
+							<< num_nodes << ",\"num_functions\":"
+							<< num_functions << ",\"ops\":" << result.ops
+							<< ",\"ns_per_op\":" << result.ns_per_op
+							<< ",\"ns_per_op_min\":" << result.ns_per_op_min
+							<< ",\"node_evals_per_s\":";
+
+					if (result.node_evals_per_s > 0.0) {
+						std::cout << result.node_evals_per_s;
+					} else {
+						std::cout << "null";
+					}
+
+					std::cout << ",\"allocs_per_op\":" << result.allocs_per_op
+							<< ",\"bytes_per_op\":" << result.bytes_per_op
+							<< "}";
+
+					first = false;
+				}
+			}
+		}
+	}
+
+	std::cout << "\n]}" << std::endl;
+}
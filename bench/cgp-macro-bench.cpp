@@ -0,0 +1,633 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: cgp-macro-bench.cpp
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+// End-to-end benchmark of CGP++ that serves as an acceptance test of a build.
+// For each benchmark file in data/plufiles and data/datfiles with at most the
+// given number of inputs and each parameter file in the bench folder, CGP++ is run
+// with a fixed seed and a fixed budget of fitness evaluations. The shipped parameter
+// file bench/bench.params is chosen so that the jobs of the small problems reach
+// the ideal fitness within the budget. The wall time, the fitness evaluations per
+// second, the peak resident memory and the success rate of the jobs are reported.
+// The results can be written to a baseline file and compared with a baseline file
+// written by an earlier build, in which case regressions beyond the tolerance are
+// flagged and the exit code is 1. Logic synthesis problems are run by the default
+// build and symbolic regression problems by the build with floating point types
+// (cgp-sr).
+//
+// Before the runs, the speed of the host is measured with a fixed workload that does
+// not depend on CGP++. The speed is stored in the baseline file and the wall time and
+// evaluations per second of the baseline are scaled by the ratio of the speeds before
+// the comparison. The calibration only accounts for the speed of a core, so a baseline
+// should be regenerated on the machine it is compared on.
+//
+// usage: cgp-macro-bench <options> [DATAFILE ...]
+//
+// -e <value>    fitness evaluations per job (default 20000)
+// -j <value>    jobs per problem (default 5)
+// -s <value>    global seed (default 1234)
+// -i <value>    maximum number of inputs of the shipped problems (default 10)
+// -t <value>    relative tolerance of the comparison (default 0.1)
+// -P <folder>   folder of the parameter files (default bench)
+// -B <file>     baseline file to compare with
+// -W <file>     file the results are written to as a new baseline
+// -L <path>     CGP++ for logic synthesis (default build/cartesian-genetic-programming)
+// -S <path>     CGP++ for symbolic regression (default build/cgp-sr)
+//
+// Example: ./build/cgp-macro-bench -W baseline.txt
+//          ./build/cgp-macro-bench -B baseline.txt
+//
+// A baseline of the default options is kept in bench/baseline.txt.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <map>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdint>
+
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/// @brief Result of the jobs of a problem with a parameter file.
+struct Result {
+	std::string datafile;
+	std::string parfile;
+	double wall_time = 0.0;
+	long long evaluations = 0;
+	double evaluations_per_second = 0.0;
+	long peak_rss = 0;
+	int num_jobs = 0;
+	int num_successes = 0;
+	bool failed = false;
+
+	double success_rate() const {
+		return num_jobs > 0 ? (double) num_successes / num_jobs : 0.0;
+	}
+};
+
+/// @brief Returns the sorted paths of the files with an extension in a folder.
+std::vector<std::string> list_files(const std::string &folder,
+		const std::string &extension) {
+	std::vector<std::string> files;
+
+	if (std::filesystem::is_directory(folder)) {
+		for (auto &entry : std::filesystem::directory_iterator(folder)) {
+			if (entry.path().extension() == extension) {
+				files.push_back(entry.path().string());
+			}
+		}
+	}
+
+	std::sort(files.begin(), files.end());
+	return files;
+}
+
+/// @brief Measures the speed of the host in operations per second.
+/// @details The workload mixes the bitwise operations of the evaluation with the
+/// generation of random numbers on a small working set and does not depend on CGP++,
+/// so a regression of a build does not change the calibration. The fastest of
+/// several rounds is taken to reduce the influence of other processes.
+double calibrate() {
+	const long long num_operations = 1 << 25;
+	const int num_rounds = 5;
+
+	std::vector<uint64_t> words(1024, 0x5555555555555555ULL);
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	double best = 0.0;
+
+	for (int round = 0; round < num_rounds; round++) {
+		auto start = std::chrono::steady_clock::now();
+
+		for (long long i = 0; i < num_operations; i++) {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+
+			uint64_t &word = words[i & 1023];
+			word = (word & state) | ~(word ^ (state >> 3));
+		}
+
+		auto end = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(end - start).count();
+		best = std::max(best, num_operations / seconds);
+	}
+
+	// Keep the workload from being optimized away
+	volatile uint64_t sink = state;
+	for (uint64_t word : words) {
+		sink = sink ^ word;
+	}
+
+	return best;
+}
+
+/// @brief Reads the number of inputs and outputs from the header of a benchmark file.
+void read_header(const std::string &datafile, int &num_inputs,
+		int &num_outputs) {
+	std::ifstream ifs(datafile);
+	if (!ifs.is_open()) {
+		throw std::runtime_error("Could not open benchmark file " + datafile);
+	}
+
+	num_inputs = -1;
+	num_outputs = -1;
+
+	std::string line;
+	while (std::getline(ifs, line) && (num_inputs < 0 || num_outputs < 0)) {
+		std::stringstream ss(line);
+		std::string key;
+		int value;
+		if (ss >> key >> value) {
+			if (key == ".i") {
+				num_inputs = value;
+			} else if (key == ".o") {
+				num_outputs = value;
+			}
+		}
+	}
+
+	if (num_inputs < 0 || num_outputs < 0) {
+		throw std::runtime_error("Missing header in benchmark file " + datafile);
+	}
+}
+
+/// @brief Reads the parameters of a parameter file up to the end marker.
+std::map<std::string, std::string> read_parfile(const std::string &parfile) {
+	std::ifstream ifs(parfile);
+	if (!ifs.is_open()) {
+		throw std::runtime_error("Could not open parameter file " + parfile);
+	}
+
+	std::map<std::string, std::string> parameters;
+	std::string line;
+
+	while (std::getline(ifs, line)) {
+		std::stringstream ss(line);
+		std::string key;
+		std::string value;
+		if (ss >> key) {
+			if (key == ".e") {
+				break;
+			}
+			if (ss >> value) {
+				parameters[key] = value;
+			}
+		}
+	}
+
+	return parameters;
+}
+
+/// @brief Writes a copy of a parameter file in which some parameters are replaced.
+/// @details Parameters that are not part of the file are added in front of the others.
+void write_parfile(const std::string &source, const std::string &target,
+		const std::map<std::string, std::string> &overrides) {
+	std::ifstream ifs(source);
+	std::ofstream ofs(target, std::ofstream::out | std::ofstream::trunc);
+
+	if (!ifs.is_open() || !ofs.is_open()) {
+		throw std::runtime_error("Could not copy parameter file " + source);
+	}
+
+	std::map<std::string, std::string> parameters = read_parfile(source);
+
+	for (auto &override : overrides) {
+		if (parameters.count(override.first) == 0) {
+			ofs << override.first << " " << override.second << "\n";
+		}
+	}
+
+	std::string line;
+	while (std::getline(ifs, line)) {
+		std::stringstream ss(line);
+		std::string key;
+		ss >> key;
+
+		auto it = overrides.find(key);
+		if (it != overrides.end()) {
+			ofs << key << " " << it->second << "\n";
+		} else {
+			ofs << line << "\n";
+		}
+	}
+}
+
+/// @brief Runs a program and collects its standard output and peak resident memory.
+/// @param args program and arguments
+/// @param output standard output of the program
+/// @param peak_rss peak resident memory of the program in KiB
+/// @return true if the program exited with code 0
+bool run(const std::vector<std::string> &args, std::string &output,
+		long &peak_rss) {
+	int fds[2];
+	if (pipe(fds) != 0) {
+		throw std::runtime_error("Could not create pipe!");
+	}
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		throw std::runtime_error("Could not fork!");
+	}
+
+	if (pid == 0) {
+		std::vector<char*> argv;
+		for (auto &arg : args) {
+			argv.push_back(const_cast<char*>(arg.c_str()));
+		}
+		argv.push_back(nullptr);
+
+		dup2(fds[1], STDOUT_FILENO);
+		close(fds[0]);
+		close(fds[1]);
+		execv(argv[0], argv.data());
+		_exit(127);
+	}
+
+	close(fds[1]);
+
+	char buffer[4096];
+	ssize_t received;
+	while ((received = read(fds[0], buffer, sizeof(buffer))) > 0) {
+		output.append(buffer, received);
+	}
+	close(fds[0]);
+
+	int status = 0;
+	struct rusage usage;
+	wait4(pid, &status, 0, &usage);
+	peak_rss = usage.ru_maxrss;
+
+	return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/// @brief Runs the jobs of a problem with a parameter file.
+Result run_problem(const std::string &binary, const std::string &datafile,
+		const std::string &parfile, int num_jobs, long long budget,
+		long long seed) {
+
+	Result result;
+	result.datafile = datafile;
+	result.parfile = parfile;
+
+	int num_inputs;
+	int num_outputs;
+	read_header(datafile, num_inputs, num_outputs);
+
+	std::map<std::string, std::string> parameters = read_parfile(parfile);
+	double ideal_fitness =
+			parameters.count("ideal_fitness") == 1 ?
+					std::stod(parameters["ideal_fitness"]) : 0.0;
+	bool minimizing = parameters["minimizing_fitness"] != "0";
+
+	// The seed is fixed and the reports are reduced to the reports after the jobs,
+	// nothing is written to the data folder
+	std::map<std::string, std::string> overrides = { { "generate_random_seed",
+			"0" }, { "global_seed", std::to_string(seed) }, {
+			"print_configuration", "0" }, { "report_during_job", "0" }, {
+			"report_after_job", "1" }, { "report_simple", "0" }, {
+			"write_statfile", "0" }, { "write_tracefile", "0" }, {
+			"checkpointing", "0" } };
+
+	std::filesystem::path fixed_parfile = std::filesystem::temp_directory_path()
+			/ ("cgp-macro-bench-" + std::to_string(getpid()) + ".params");
+	write_parfile(parfile, fixed_parfile.string(), overrides);
+
+	std::vector<std::string> args = { binary, datafile, fixed_parfile.string(),
+			"-v", std::to_string(num_inputs), "-o", std::to_string(num_outputs),
+			"-e", std::to_string(budget), "-j", std::to_string(num_jobs) };
+
+	std::string output;
+	auto start = std::chrono::steady_clock::now();
+	bool exited = run(args, output, result.peak_rss);
+	auto end = std::chrono::steady_clock::now();
+
+	std::filesystem::remove(fixed_parfile);
+
+	result.wall_time = std::chrono::duration<double>(end - start).count();
+
+	// Job # 1 :: Evaluations: 10001 :: Best Fitness: 2 :: Runtime (s): ...
+	std::stringstream lines(output);
+	std::string line;
+	while (std::getline(lines, line)) {
+		std::size_t evaluations = line.find("Evaluations: ");
+		std::size_t fitness = line.find("Best Fitness: ");
+		if (line.rfind("Job # ", 0) != 0 || evaluations == std::string::npos
+				|| fitness == std::string::npos) {
+			continue;
+		}
+
+		double best = std::stod(line.substr(fitness + 14));
+		result.evaluations += std::stoll(line.substr(evaluations + 13));
+		result.num_jobs++;
+
+		if (minimizing ? best <= ideal_fitness : best >= ideal_fitness) {
+			result.num_successes++;
+		}
+	}
+
+	result.failed = !exited || result.num_jobs != num_jobs;
+	result.evaluations_per_second =
+			result.wall_time > 0.0 ? result.evaluations / result.wall_time : 0.0;
+
+	return result;
+}
+
+/// @brief Reads the results of a baseline file, keyed by benchmark and parameter file.
+/// @param path path of the baseline file
+/// @param calibration speed of the host the baseline has been written on, 0 if the
+/// baseline does not contain it
+std::map<std::string, Result> read_baseline(const std::string &path,
+		double &calibration) {
+	std::ifstream ifs(path);
+	if (!ifs.is_open()) {
+		throw std::runtime_error("Could not open baseline file " + path);
+	}
+
+	std::map<std::string, Result> baseline;
+	std::string line;
+	calibration = 0.0;
+
+	while (std::getline(ifs, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+
+		std::stringstream ss(line);
+
+		if (line.rfind("calibration ", 0) == 0) {
+			std::string key;
+			ss >> key >> calibration;
+			continue;
+		}
+
+		Result result;
+		double success_rate;
+
+		if (ss >> result.datafile >> result.parfile >> result.wall_time
+				>> result.evaluations_per_second >> result.peak_rss
+				>> success_rate) {
+			result.num_jobs = 1000;
+			result.num_successes = (int) (success_rate * 1000 + 0.5);
+			baseline[result.datafile + " " + result.parfile] = result;
+		}
+	}
+
+	return baseline;
+}
+
+/// @brief Writes the results in the format of a baseline file.
+void write_baseline(const std::string &path,
+		const std::vector<Result> &results, double calibration) {
+	std::ofstream ofs(path, std::ofstream::out | std::ofstream::trunc);
+	if (!ofs.is_open()) {
+		throw std::runtime_error("Could not open baseline file " + path);
+	}
+
+	ofs << "# datafile parfile wall_time_s evaluations_per_s peak_rss_kib success_rate"
+			<< std::endl;
+	ofs << "calibration " << calibration << std::endl;
+
+	for (const Result &result : results) {
+		if (!result.failed) {
+			ofs << result.datafile << " " << result.parfile << " "
+					<< result.wall_time << " " << result.evaluations_per_second
+					<< " " << result.peak_rss << " " << result.success_rate()
+					<< std::endl;
+		}
+	}
+}
+
+/// @brief Compares a result with its baseline.
+/// @param result result of the current build
+/// @param reference result of the baseline
+/// @param speedup speed of the host relative to the host of the baseline
+/// @param tolerance relative tolerance of the comparison
+/// @return descriptions of the regressions beyond the tolerance
+std::vector<std::string> compare(const Result &result, const Result &reference,
+		double speedup, double tolerance) {
+	std::vector<std::string> regressions;
+
+	Result base = reference;
+	base.wall_time /= speedup;
+	base.evaluations_per_second *= speedup;
+
+	auto change = [](double value, double reference) {
+		std::stringstream ss;
+		ss << std::showpos << std::fixed << std::setprecision(1)
+				<< (value / reference - 1.0) * 100.0 << "%";
+		return ss.str();
+	};
+
+	if (result.wall_time > base.wall_time * (1.0 + tolerance)) {
+		regressions.push_back(
+				"wall time " + change(result.wall_time, base.wall_time));
+	}
+
+	if (result.evaluations_per_second
+			< base.evaluations_per_second * (1.0 - tolerance)) {
+		regressions.push_back(
+				"evaluations/s "
+						+ change(result.evaluations_per_second,
+								base.evaluations_per_second));
+	}
+
+	if (result.peak_rss > base.peak_rss * (1.0 + tolerance)) {
+		regressions.push_back(
+				"peak RSS " + change(result.peak_rss, base.peak_rss));
+	}
+
+	if (result.success_rate() < base.success_rate() - tolerance) {
+		std::stringstream ss;
+		ss << "success rate " << base.success_rate() << " -> "
+				<< result.success_rate();
+		regressions.push_back(ss.str());
+	}
+
+	return regressions;
+}
+
+void usage() {
+	std::cerr << "usage: cgp-macro-bench <options> [DATAFILE ...]" << std::endl;
+	std::cerr << "-e <value>    fitness evaluations per job" << std::endl;
+	std::cerr << "-j <value>    jobs per problem" << std::endl;
+	std::cerr << "-s <value>    global seed" << std::endl;
+	std::cerr << "-i <value>    maximum number of inputs of the shipped problems"
+			<< std::endl;
+	std::cerr << "-t <value>    relative tolerance of the comparison"
+			<< std::endl;
+	std::cerr << "-P <folder>   folder of the parameter files" << std::endl;
+	std::cerr << "-B <file>     baseline file to compare with" << std::endl;
+	std::cerr << "-W <file>     file the results are written to" << std::endl;
+	std::cerr << "-L <path>     CGP++ for logic synthesis" << std::endl;
+	std::cerr << "-S <path>     CGP++ for symbolic regression" << std::endl;
+	exit(1);
+}
+
+int main(int argc, char **argv) {
+
+	long long budget = 20000;
+	int num_jobs = 5;
+	long long seed = 1234;
+	int max_inputs = 10;
+	double tolerance = 0.1;
+
+	std::string parfile_folder = "bench";
+	std::string baseline_file;
+	std::string results_file;
+	std::string ls_binary = "build/cartesian-genetic-programming";
+	std::string sr_binary = "build/cgp-sr";
+
+	int opt;
+	while ((opt = getopt(argc, argv, "e:j:s:i:t:P:B:W:L:S:")) != -1) {
+		switch (opt) {
+		case 'e':
+			budget = atol(optarg);
+			break;
+		case 'j':
+			num_jobs = atoi(optarg);
+			break;
+		case 's':
+			seed = atol(optarg);
+			break;
+		case 'i':
+			max_inputs = atoi(optarg);
+			break;
+		case 't':
+			tolerance = atof(optarg);
+			break;
+		case 'P':
+			parfile_folder = optarg;
+			break;
+		case 'B':
+			baseline_file = optarg;
+			break;
+		case 'W':
+			results_file = optarg;
+			break;
+		case 'L':
+			ls_binary = optarg;
+			break;
+		case 'S':
+			sr_binary = optarg;
+			break;
+		default:
+			usage();
+		}
+	}
+
+	std::vector<std::string> datafiles;
+	for (int i = optind; i < argc; i++) {
+		datafiles.push_back(argv[i]);
+	}
+
+	// The number of fitness cases grows with the number of inputs, which
+	// would let the largest problems dominate the runtime of the benchmark
+	if (datafiles.empty()) {
+		std::vector<std::string> shipped = list_files("data/plufiles", ".plu");
+		std::vector<std::string> datfiles = list_files("data/datfiles", ".dat");
+		shipped.insert(shipped.end(), datfiles.begin(), datfiles.end());
+
+		for (const std::string &datafile : shipped) {
+			int num_inputs;
+			int num_outputs;
+			read_header(datafile, num_inputs, num_outputs);
+			if (num_inputs <= max_inputs) {
+				datafiles.push_back(datafile);
+			}
+		}
+	}
+
+	std::vector<std::string> parfiles = list_files(parfile_folder, ".params");
+
+	double calibration = calibrate();
+	double speedup = 1.0;
+
+	std::map<std::string, Result> baseline;
+	if (!baseline_file.empty()) {
+		double base_calibration;
+		baseline = read_baseline(baseline_file, base_calibration);
+		if (base_calibration > 0.0) {
+			speedup = calibration / base_calibration;
+		}
+	}
+
+	std::cout << "Calibration: " << std::fixed << std::setprecision(0)
+			<< calibration << " operations/s";
+	if (!baseline_file.empty()) {
+		std::cout << ", " << std::setprecision(2) << speedup
+				<< "x the host of the baseline";
+	}
+	std::cout << std::endl << std::endl;
+
+	std::vector<Result> results;
+	int num_failures = 0;
+	int num_regressions = 0;
+
+	std::cout << std::left << std::setw(36) << "Problem" << std::setw(24)
+			<< "Parameters" << std::right << std::setw(10) << "Wall (s)"
+			<< std::setw(14) << "Evals/s" << std::setw(16) << "Peak RSS (KiB)"
+			<< std::setw(10) << "Success" << std::endl;
+
+	for (const std::string &parfile : parfiles) {
+		for (const std::string &datafile : datafiles) {
+			const std::string &binary =
+					datafile.find(".plu") != std::string::npos ?
+							ls_binary : sr_binary;
+
+			Result result = run_problem(binary, datafile, parfile, num_jobs,
+					budget, seed);
+			results.push_back(result);
+
+			std::cout << std::left << std::setw(36) << datafile << std::setw(24)
+					<< std::filesystem::path(parfile).filename().string()
+					<< std::right << std::fixed << std::setprecision(2)
+					<< std::setw(10) << result.wall_time << std::setprecision(0)
+					<< std::setw(14) << result.evaluations_per_second
+					<< std::setw(16) << result.peak_rss << std::setprecision(2)
+					<< std::setw(10) << result.success_rate();
+
+			if (result.failed) {
+				std::cout << "  FAILED";
+				num_failures++;
+			}
+
+			auto base = baseline.find(datafile + " " + parfile);
+			if (!result.failed && base != baseline.end()) {
+				for (const std::string &regression : compare(result,
+						base->second, speedup, tolerance)) {
+					std::cout << "  REGRESSION: " << regression;
+					num_regressions++;
+				}
+			}
+
+			std::cout << std::endl;
+		}
+	}
+
+	if (!results_file.empty()) {
+		write_baseline(results_file, results, calibration);
+	}
+
+	std::cout << std::endl << results.size() << " runs, " << num_failures
+			<< " failed, " << num_regressions << " regressions" << std::endl;
+
+	return num_failures > 0 || num_regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,342 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: cgp-scaling.cpp
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+// Thread scaling and determinism test of the concurrent evaluation. The same
+// seeded jobs are run with 1, 2, 4, ... evaluation threads up to the number of
+// cores. The number of fitness evaluations, the best fitness and the genomes and
+// fitness values of the final population of each job must be bit-identical to the
+// run with one thread. For each number of threads, the runtime of the jobs, the
+// speedup and the parallel efficiency are printed along with a bar chart of the
+// speedup. The exit code is 1 if any job differs from the run with one thread.
+// The asynchronous steady-state algorithm replaces individuals in the order in
+// which the evaluations complete, so its runs are not expected to be identical.
+// The evaluation, genome and fitness types are the ones of template_types.h.
+//
+// usage: cgp-scaling DATAFILE PARFILE <options>
+//
+// The options -a, -b, -n, -f, -r, -p, -c, -m, -l, -e and -s are the ones of CGP++.
+// -j <value>    number of jobs (default 3)
+// -t <value>    maximum number of evaluation threads (default number of cores)
+//
+// Example: ./build/cgp-scaling data/plufiles/add3.plu data/parfiles/cgp.params -a 1 -b 10 -n 500 -m 4 -l 16 -e 20000
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <stdexcept>
+
+#include <getopt.h>
+
+#include "../template/template_types.h"
+#include "../validation/Validation.h"
+#include "../representation/Individual.h"
+#include "../initializer/SymbolicRegressionInitializer.h"
+#include "../initializer/LogicSynthesisInitializer.h"
+#include "../random/Random.h"
+
+/// @brief Outcome of a job that is compared across the numbers of threads.
+struct Outcome {
+	int evaluations;
+	FITNESS_TYPE best_fitness;
+	std::vector<GENOME_TYPE> genomes;
+	std::vector<FITNESS_TYPE> fitness_values;
+	double runtime;
+};
+
+/// @brief Compares two values bit by bit, so that e.g. floating point values
+/// that differ in the last digit are not considered equal.
+template<class T>
+bool identical(const T &a, const T &b) {
+	return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template<class T>
+bool identical(const std::vector<T> &a, const std::vector<T> &b) {
+	return a.size() == b.size()
+			&& std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0;
+}
+
+/// @brief Runs a job with an isolated composite and collects its outcome.
+/// @param initializer initializer of the experiment
+/// @param job job number
+/// @param seed seed of the job
+/// @return outcome of the job
+Outcome run_job(
+		std::shared_ptr<
+				BlackBoxInitializer<EVALUATION_TYPE, GENOME_TYPE, FITNESS_TYPE>> initializer,
+		int job, long long seed) {
+
+	std::shared_ptr<
+			EvolutionaryAlgorithm<EVALUATION_TYPE, GENOME_TYPE, FITNESS_TYPE>> algorithm =
+			initializer->init_job(job, seed);
+
+	auto start = std::chrono::steady_clock::now();
+	std::pair<int, FITNESS_TYPE> result = algorithm->evolve();
+	auto end = std::chrono::steady_clock::now();
+
+	Outcome outcome;
+	outcome.evaluations = result.first;
+	outcome.best_fitness = result.second;
+	outcome.runtime = std::chrono::duration<double>(end - start).count();
+
+	std::shared_ptr<AbstractPopulation<GENOME_TYPE, FITNESS_TYPE>> population =
+			algorithm->get_population();
+	int genome_size = initializer->get_parameters()->get_genome_size();
+
+	for (int i = 0; i < population->size(); i++) {
+		std::shared_ptr<Individual<GENOME_TYPE, FITNESS_TYPE>> individual =
+				population->get_individual(i);
+		std::shared_ptr<GENOME_TYPE[]> genome = individual->get_genome();
+
+		outcome.genomes.insert(outcome.genomes.end(), genome.get(),
+				genome.get() + genome_size);
+		outcome.fitness_values.push_back(individual->get_fitness());
+	}
+
+	return outcome;
+}
+
+void usage() {
+	std::cerr << "usage: cgp-scaling DATAFILE PARFILE <options>" << std::endl;
+	std::cerr
+			<< "-a, -b, -n, -f, -r, -p, -c, -m, -l, -e, -s  options of CGP++"
+			<< std::endl;
+	std::cerr << "-j <value>    number of jobs" << std::endl;
+	std::cerr << "-t <value>    maximum number of evaluation threads"
+			<< std::endl;
+	exit(1);
+}
+
+int main(int argc, char **argv) {
+
+	if (argc < 3) {
+		usage();
+	}
+
+	std::string data_file = argv[1];
+	std::string param_file = argv[2];
+
+	int algorithm = -1;
+	int levels_back = -1;
+	int num_nodes = -1;
+	int num_functions = -1;
+	int max_arity = -1;
+	int num_parents = -1;
+	int num_offspring = -1;
+	float mutation_rate = -1;
+	float crossover_rate = -1;
+	long long max_fitness_evaluations = -1;
+	long long global_seed = 1234;
+
+	int num_jobs = 3;
+	int max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+	optind = 3;
+
+	int opt;
+	while ((opt = getopt(argc, argv, "a:b:n:f:r:p:c:m:l:e:s:j:t:")) != -1) {
+		switch (opt) {
+		case 'a':
+			algorithm = atoi(optarg);
+			break;
+		case 'b':
+			levels_back = atoi(optarg);
+			break;
+		case 'n':
+			num_nodes = atoi(optarg);
+			break;
+		case 'f':
+			num_functions = atoi(optarg);
+			break;
+		case 'r':
+			max_arity = atoi(optarg);
+			break;
+		case 'p':
+			mutation_rate = atof(optarg);
+			break;
+		case 'c':
+			crossover_rate = atof(optarg);
+			break;
+		case 'm':
+			num_parents = atoi(optarg);
+			break;
+		case 'l':
+			num_offspring = atoi(optarg);
+			break;
+		case 'e':
+			max_fitness_evaluations = atol(optarg);
+			break;
+		case 's':
+			global_seed = atol(optarg);
+			break;
+		case 'j':
+			num_jobs = std::max(1, atoi(optarg));
+			break;
+		case 't':
+			max_threads = std::max(1, atoi(optarg));
+			break;
+		default:
+			usage();
+		}
+	}
+
+	// Create the initializer for the problem domain as CGP++ does
+	// ---------------------------------------------------------------------------------------
+	std::shared_ptr<
+			BlackBoxInitializer<EVALUATION_TYPE, GENOME_TYPE, FITNESS_TYPE>> initializer;
+
+	if (data_file.find(".plu") != std::string::npos) {
+		if constexpr (Validation::validate_ls_type()) {
+			initializer = std::make_shared<
+					LogicSynthesisInitializer<EVALUATION_TYPE, GENOME_TYPE,
+							FITNESS_TYPE>>(data_file);
+		} else {
+			throw std::invalid_argument(
+					"Evaluation type is not supported for logic synthesis!");
+		}
+	} else if (data_file.find(".dat") != std::string::npos) {
+		if constexpr (Validation::validate_sr_type()) {
+			initializer = std::make_shared<
+					SymbolicRegressionInitializer<EVALUATION_TYPE, GENOME_TYPE,
+							FITNESS_TYPE>>(data_file);
+		} else {
+			throw std::invalid_argument(
+					"Evaluation type is not supported for symbolic regression!");
+		}
+	} else {
+		throw std::invalid_argument("Datatype is not supported!");
+	}
+
+	// The data is read before the command line parameters are applied, so the
+	// genome size is computed with the inputs and outputs of the benchmark
+	// ---------------------------------------------------------------------------------------
+	initializer->init_parfile_parameters(param_file);
+	initializer->read_data();
+
+	initializer->init_comandline_parameters(algorithm, num_nodes, -1, -1, -1,
+			num_functions, max_arity, num_parents, num_offspring, mutation_rate,
+			max_fitness_evaluations, -1, num_jobs, global_seed, -1, -1, -1, -1,
+			crossover_rate, levels_back);
+
+	std::shared_ptr<Parameters> parameters = initializer->get_parameters();
+	parameters->set_report_during_job(false);
+	parameters->set_checkpointing(false);
+	parameters->set_write_tracefile(false);
+
+	initializer->init_functions();
+
+	// Run the jobs with each number of threads, the first run is the reference
+	// ---------------------------------------------------------------------------------------
+	std::vector<int> thread_counts;
+	for (int n = 1; n < max_threads; n *= 2) {
+		thread_counts.push_back(n);
+	}
+	thread_counts.push_back(max_threads);
+
+	std::vector<Outcome> reference;
+	double reference_runtime = 0.0;
+	int num_mismatches = 0;
+
+	std::cout << std::setw(8) << "Threads" << std::setw(12) << "Runtime (s)"
+			<< std::setw(10) << "Speedup" << std::setw(12) << "Efficiency"
+			<< "  Determinism" << std::endl;
+
+	std::stringstream chart;
+
+	for (int num_threads : thread_counts) {
+		parameters->set_num_eval_threads(num_threads);
+		parameters->set_eval_chunk_size();
+
+		double runtime = 0.0;
+		std::vector<std::string> mismatches;
+
+		for (int job = 1; job <= num_jobs; job++) {
+			Outcome outcome = run_job(initializer, job,
+					Random::derive_seed(global_seed, job));
+			runtime += outcome.runtime;
+
+			if (num_threads == 1) {
+				reference.push_back(outcome);
+				continue;
+			}
+
+			const Outcome &expected = reference.at(job - 1);
+			std::string prefix = "job " + std::to_string(job) + ": ";
+
+			if (outcome.evaluations != expected.evaluations) {
+				mismatches.push_back(prefix + "evaluations");
+			}
+			if (!identical(outcome.best_fitness, expected.best_fitness)) {
+				mismatches.push_back(prefix + "best fitness");
+			}
+			if (!identical(outcome.genomes, expected.genomes)) {
+				mismatches.push_back(prefix + "genomes");
+			}
+			if (!identical(outcome.fitness_values, expected.fitness_values)) {
+				mismatches.push_back(prefix + "fitness values");
+			}
+		}
+
+		if (num_threads == 1) {
+			reference_runtime = runtime;
+		}
+
+		double speedup = runtime > 0.0 ? reference_runtime / runtime : 0.0;
+		double efficiency = speedup / num_threads;
+
+		std::cout << std::setw(8) << num_threads << std::fixed
+				<< std::setprecision(3) << std::setw(12) << runtime
+				<< std::setprecision(2) << std::setw(10) << speedup
+				<< std::setw(12) << efficiency << "  ";
+
+		if (num_threads == 1) {
+			std::cout << "reference";
+		} else if (mismatches.empty()) {
+			std::cout << "identical";
+		} else {
+			std::cout << "DIFFERENT (";
+			for (std::size_t i = 0; i < mismatches.size(); i++) {
+				std::cout << (i > 0 ? ", " : "") << mismatches[i];
+			}
+			std::cout << ")";
+			num_mismatches++;
+		}
+
+		std::cout << std::endl;
+
+		// Bar of the speedup, the ideal speedup is marked with a bar
+		int width = std::max(1, 48 / max_threads);
+		int bar = (int) (speedup * width + 0.5);
+		int ideal = num_threads * width;
+
+		chart << std::setw(8) << num_threads << " |";
+		for (int i = 0; i < std::max(bar, ideal); i++) {
+			if (i == ideal - 1) {
+				chart << "|";
+			} else {
+				chart << (i < bar ? "#" : " ");
+			}
+		}
+		chart << " " << std::setprecision(2) << speedup << "x" << std::endl;
+	}
+
+	std::cout << std::endl << "Speedup (# measured, | ideal):" << std::endl
+			<< chart.str();
+
+	return num_mismatches > 0 ? 1 : 0;
+}
@@ -41,6 +41,9 @@ public:
 	BenchmarkFileReader();
 	~BenchmarkFileReader() = default;
 	void read_benchmark_file(std::string file_path);
+	void open_benchmark_file(std::string file_path);
+	bool read_instance(std::vector<E> &input_chunk,
+			std::vector<E> &output_chunk);
 	void print_data();
 
 	std::shared_ptr<std::vector<std::vector<E>>> get_input_data() const;
@@ -96,6 +99,33 @@ void BenchmarkFileReader<E>::print_data() {
 template<class E>
 void BenchmarkFileReader<E>::read_benchmark_file(std::string file_path) {
 
+	this->open_benchmark_file(file_path);
+
+	std::vector<E> input_chunk;
+	std::vector<E> output_chunk;
+
+	// Read the input and output values for each instance
+	for (int i = 0; i < num_instances; i++) {
+		this->read_instance(input_chunk, output_chunk);
+
+		inputs->push_back(input_chunk);
+		outputs->push_back(output_chunk);
+	}
+
+	if (!ifs.good()) {
+		throw std::runtime_error("Error while reading benchmark file!");
+	}
+
+	ifs.close();
+}
+
+/// @brief Opens the benchmark file and reads its meta information.
+/// @details The instances can then be read one after another with read_instance, 
+/// which allows to process files that do not fit into memory.
+/// @param file_path file path of the benchmark file to be read
+template<class E>
+void BenchmarkFileReader<E>::open_benchmark_file(std::string file_path) {
+
 	if (file_path.size() == 0) {
 		throw std::runtime_error("File path is an empty string!");
 	}
@@ -109,59 +139,50 @@ void BenchmarkFileReader<E>::read_benchmark_file(std::string file_path) {
 
 	ifs.open(file_path, std::ifstream::in);
 
-	char c;
-
-	if (ifs.is_open()) {
-
-		std::string str;
-		E input;
-		E output;
-
-		// Read the meta information from the file
-		ifs >> str >> num_inputs;
-		ifs >> str >> num_outputs;
-		ifs >> str >> num_instances;
-
-		std::vector<E> input_chunk;
-		std::vector<E> output_chunk;
-
-		// Read the input and output values for each instance
-		for (int i = 0; i < num_instances; i++) {
-
-			for (int j = 0; j < num_inputs; j++) {
-				ifs >> input;
-				input_chunk.push_back(input);
-			}
+	if (!ifs.is_open()) {
+		throw std::runtime_error("Error opening benchmark file!");
+	}
 
-			// Inputs and outputs are seperated with whitespaces
-			// Therefore, we skip this whitespace
-			do {
-				ifs.get(c);
-			} while (ifs.peek() == ' ');
+	std::string str;
 
-			for (int j = 0; j < num_outputs; j++) {
-				ifs >> output;
-				output_chunk.push_back(output);
-			}
+	// Read the meta information from the file
+	ifs >> str >> num_inputs;
+	ifs >> str >> num_outputs;
+	ifs >> str >> num_instances;
+}
 
+/// @brief Reads the next instance of an opened benchmark file.
+/// @param input_chunk vector that receives the input values
+/// @param output_chunk vector that receives the output values
+/// @return false if the instance could not be read
+template<class E>
+bool BenchmarkFileReader<E>::read_instance(std::vector<E> &input_chunk,
+		std::vector<E> &output_chunk) {
 
-			inputs->push_back(input_chunk);
-			outputs->push_back(output_chunk);
+	E input;
+	E output;
+	char c;
 
-			input_chunk.clear();
-			output_chunk.clear();
-		}
+	input_chunk.clear();
+	output_chunk.clear();
 
-		if (!ifs.good()) {
-			throw std::runtime_error("Error while reading benchmark file!");
-		}
+	for (int j = 0; j < num_inputs; j++) {
+		ifs >> input;
+		input_chunk.push_back(input);
+	}
 
-		ifs.close();
+	// Inputs and outputs are seperated with whitespaces
+	// Therefore, we skip this whitespace
+	do {
+		ifs.get(c);
+	} while (ifs.peek() == ' ');
 
-	} else {
-		throw std::runtime_error("Error opening benchmark file!");
+	for (int j = 0; j < num_outputs; j++) {
+		ifs >> output;
+		output_chunk.push_back(output);
 	}
 
+	return !ifs.fail();
 }
 
 template<class E>
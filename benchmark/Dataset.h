@@ -0,0 +1,183 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: Dataset.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef BENCHMARK_DATASET_H_
+#define BENCHMARK_DATASET_H_
+
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+/// @brief Immutable input/output data of a benchmark in column-major layout.
+/// @details The values of each input and output variable are stored contiguously,
+/// first the input columns and then the output columns. The storage is referenced
+/// by a shared pointer, so it can either be owned by the dataset or belong to a
+/// memory mapping that is released together with the last reference.
+/// Problems and their clones share one dataset; copies are only made 
+/// explicitly, e.g. for replicas on other NUMA nodes.
+/// @tparam E Evaluation Type
+template<class E>
+class Dataset {
+private:
+	int num_instances;
+	int num_inputs;
+	int num_outputs;
+
+	std::shared_ptr<const E> data;
+
+public:
+	Dataset(const std::vector<std::vector<E>> &p_inputs,
+			const std::vector<std::vector<E>> &p_outputs);
+	Dataset(std::shared_ptr<const E> p_data, int p_num_instances,
+			int p_num_inputs, int p_num_outputs);
+	Dataset(const Dataset &dataset);
+	virtual ~Dataset() = default;
+
+	const E* input_column(int input) const;
+	const E* output_column(int output) const;
+	E input(int instance, int input) const;
+	E output(int instance, int output) const;
+
+	const E* get_data() const;
+	std::size_t size() const;
+
+	int get_num_instances() const;
+	int get_num_inputs() const;
+	int get_num_outputs() const;
+};
+
+/// @brief Constructor that transposes row-major instances into the column layout.
+/// @param p_inputs input values of each instance
+/// @param p_outputs output values of each instance
+template<class E>
+Dataset<E>::Dataset(const std::vector<std::vector<E>> &p_inputs,
+		const std::vector<std::vector<E>> &p_outputs) {
+
+	if (p_inputs.size() != p_outputs.size() || p_inputs.empty()) {
+		throw std::invalid_argument("Invalid dimension of the dataset!");
+	}
+
+	num_instances = p_inputs.size();
+	num_inputs = p_inputs.at(0).size();
+	num_outputs = p_outputs.at(0).size();
+
+	std::shared_ptr<E[]> values(new E[this->size()]);
+
+	for (int i = 0; i < num_instances; i++) {
+		if ((int) p_inputs.at(i).size() != num_inputs
+				|| (int) p_outputs.at(i).size() != num_outputs) {
+			throw std::invalid_argument("Invalid dimension of the dataset!");
+		}
+
+		for (int j = 0; j < num_inputs; j++) {
+			values[j * num_instances + i] = p_inputs.at(i).at(j);
+		}
+
+		for (int j = 0; j < num_outputs; j++) {
+			values[(num_inputs + j) * num_instances + i] = p_outputs.at(i).at(j);
+		}
+	}
+
+	data = std::shared_ptr<const E>(values, values.get());
+}
+
+/// @brief Constructor that wraps existing column-major storage.
+/// @param p_data storage of at least (p_num_inputs + p_num_outputs) * p_num_instances values
+/// @param p_num_instances number of instances
+/// @param p_num_inputs number of input variables
+/// @param p_num_outputs number of output variables
+template<class E>
+Dataset<E>::Dataset(std::shared_ptr<const E> p_data, int p_num_instances,
+		int p_num_inputs, int p_num_outputs) {
+
+	if (p_data == nullptr) {
+		throw std::invalid_argument("Nullpointer exception in dataset class!");
+	}
+
+	data = p_data;
+	num_instances = p_num_instances;
+	num_inputs = p_num_inputs;
+	num_outputs = p_num_outputs;
+}
+
+/// @brief Copy constructor for deep cloning into owned storage.
+/// @param dataset dataset to clone
+template<class E>
+Dataset<E>::Dataset(const Dataset &dataset) {
+	num_instances = dataset.num_instances;
+	num_inputs = dataset.num_inputs;
+	num_outputs = dataset.num_outputs;
+
+	std::shared_ptr<E[]> values(new E[this->size()]);
+	std::copy(dataset.data.get(), dataset.data.get() + this->size(),
+			values.get());
+
+	data = std::shared_ptr<const E>(values, values.get());
+}
+
+/// @brief Returns the values of an input variable for all instances.
+/// @param input index of the input variable
+/// @return pointer to the first value of the column
+template<class E>
+const E* Dataset<E>::input_column(int input) const {
+	return this->data.get() + (std::size_t) input * this->num_instances;
+}
+
+/// @brief Returns the values of an output variable for all instances.
+/// @param output index of the output variable
+/// @return pointer to the first value of the column
+template<class E>
+const E* Dataset<E>::output_column(int output) const {
+	return this->data.get()
+			+ (std::size_t) (this->num_inputs + output) * this->num_instances;
+}
+
+template<class E>
+E Dataset<E>::input(int instance, int input) const {
+	return this->input_column(input)[instance];
+}
+
+template<class E>
+E Dataset<E>::output(int instance, int output) const {
+	return this->output_column(output)[instance];
+}
+
+template<class E>
+const E* Dataset<E>::get_data() const {
+	return this->data.get();
+}
+
+/// @brief Returns the number of stored values.
+/// @return number of values
+template<class E>
+std::size_t Dataset<E>::size() const {
+	return (std::size_t) (this->num_inputs + this->num_outputs)
+			* this->num_instances;
+}
+
+template<class E>
+int Dataset<E>::get_num_instances() const {
+	return this->num_instances;
+}
+
+template<class E>
+int Dataset<E>::get_num_inputs() const {
+	return this->num_inputs;
+}
+
+template<class E>
+int Dataset<E>::get_num_outputs() const {
+	return this->num_outputs;
+}
+
+#endif /* BENCHMARK_DATASET_H_ */
@@ -0,0 +1,527 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: DatasetCache.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef BENCHMARK_DATASETCACHE_H_
+#define BENCHMARK_DATASETCACHE_H_
+
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Dataset.h"
+#include "DatasetStream.h"
+#include "BenchmarkFileReader.h"
+
+/// @brief Loads datasets through a binary cache file next to the benchmark file.
+/// @details On the first load, the benchmark file is parsed and its data is written
+/// in the column-major layout of the dataset class to DATAFILE.cgpcache. Later loads
+/// map the cache file read-only into memory, which takes constant time and lets
+/// concurrent processes share the data through the page cache.
+///
+/// The cache consists of a header and the data, which starts at a cache line
+/// aligned offset. The header holds the shape of the dataset, the size and signedness
+/// of the evaluation type, the size and modification time of the benchmark file and
+/// FNV-1a checksums of the data and of the header itself. A cache whose header does
+/// not match is rebuilt. The data checksum is only verified on request, since
+/// reading the whole file would defeat the constant-time load.
+///
+/// Datasets that do not fit into memory are streamed from the cache instead. For
+/// them, the cache is created by converting the benchmark file in blocks of
+/// instances, so neither the conversion nor the evaluation holds the whole dataset.
+/// @tparam E Evaluation Type
+template<class E>
+class DatasetCache {
+private:
+	static constexpr char MAGIC[8] = { 'C', 'G', 'P', 'D', 'S', 'E', 'T', '\0' };
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t FLOATING = 1;
+	static constexpr uint32_t SIGNED = 2;
+	static constexpr int CONVERSION_BLOCK_SIZE = 65536;
+
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t type_size;
+		uint32_t type_flags;
+		uint32_t num_inputs;
+		uint32_t num_outputs;
+		uint32_t reserved;
+		uint64_t num_instances;
+		uint64_t data_offset;
+		uint64_t source_size;
+		int64_t source_mtime;
+		uint64_t data_checksum;
+		uint64_t header_checksum;
+	};
+
+	static_assert(std::is_trivially_copyable<E>::value,
+			"Dataset cache requires a trivially copyable evaluation type!");
+
+	static uint64_t checksum(const void *data, std::size_t size,
+			uint64_t hash = 14695981039346656037ULL);
+	static uint64_t header_checksum(Header header);
+	static uint32_t type_flags();
+	static bool stat_source(const std::string &file_path, uint64_t &size,
+			int64_t &mtime);
+	static bool write_at(int fd, const void *data, std::size_t size,
+			uint64_t offset);
+
+	static Header make_header(int num_inputs, int num_outputs,
+			uint64_t num_instances, uint64_t source_size, int64_t source_mtime);
+	static bool read_header(int fd, uint64_t source_size, int64_t source_mtime,
+			Header &header);
+
+	static std::shared_ptr<Dataset<E>> map(const std::string &cache_path,
+			uint64_t source_size, int64_t source_mtime, bool verify);
+	static void write(const std::string &cache_path, const Dataset<E> &dataset,
+			uint64_t source_size, int64_t source_mtime);
+	static void convert(const std::string &file_path,
+			const std::string &cache_path, uint64_t source_size,
+			int64_t source_mtime);
+
+public:
+	static std::string cache_path(const std::string &file_path);
+	static std::shared_ptr<Dataset<E>> read(const std::string &file_path);
+	static std::shared_ptr<Dataset<E>> load(const std::string &file_path,
+			bool verify = false);
+	static std::shared_ptr<DatasetStream<E>> stream(
+			const std::string &file_path, int block_size);
+};
+
+/// @brief Returns the path of the cache file of a benchmark file.
+/// @param file_path path of the benchmark file
+/// @return path of the cache file
+template<class E>
+std::string DatasetCache<E>::cache_path(const std::string &file_path) {
+	return file_path + ".cgpcache";
+}
+
+/// @brief Parses a benchmark file without using the cache.
+/// @param file_path path of the benchmark file
+/// @return shared pointer to the dataset
+template<class E>
+std::shared_ptr<Dataset<E>> DatasetCache<E>::read(const std::string &file_path) {
+	BenchmarkFileReader<E> reader;
+	reader.read_benchmark_file(file_path);
+
+	return std::make_shared<Dataset<E>>(*reader.get_input_data(),
+			*reader.get_output_data());
+}
+
+/// @brief Loads the dataset of a benchmark file from its cache.
+/// @details The cache is created if it does not exist or is outdated. If it cannot
+/// be written, e.g. due to a read-only directory, the parsed dataset is returned.
+/// @param file_path path of the benchmark file
+/// @param verify whether the data checksum of an existing cache is verified
+/// @return shared pointer to the dataset
+template<class E>
+std::shared_ptr<Dataset<E>> DatasetCache<E>::load(const std::string &file_path,
+		bool verify) {
+
+	uint64_t source_size;
+	int64_t source_mtime;
+
+	if (!stat_source(file_path, source_size, source_mtime)) {
+		return read(file_path);
+	}
+
+	std::string path = cache_path(file_path);
+
+	std::shared_ptr<Dataset<E>> dataset = map(path, source_size, source_mtime,
+			verify);
+
+	if (dataset != nullptr) {
+		return dataset;
+	}
+
+	dataset = read(file_path);
+	write(path, *dataset, source_size, source_mtime);
+
+	return dataset;
+}
+
+/// @brief Opens a stream over the dataset of a benchmark file.
+/// @details The cache is created by a blockwise conversion if it does not exist or
+/// is outdated. Since the stream reads from the cache, failing to write it is an error.
+/// @param file_path path of the benchmark file
+/// @param block_size number of instances per block
+/// @return shared pointer to the stream
+template<class E>
+std::shared_ptr<DatasetStream<E>> DatasetCache<E>::stream(
+		const std::string &file_path, int block_size) {
+
+	uint64_t source_size;
+	int64_t source_mtime;
+
+	if (!stat_source(file_path, source_size, source_mtime)) {
+		throw std::runtime_error("Error opening benchmark file!");
+	}
+
+	std::string path = cache_path(file_path);
+	Header header;
+
+	for (int attempt = 0; attempt < 2; attempt++) {
+		int fd = open(path.c_str(), O_RDONLY);
+		bool valid = fd >= 0
+				&& read_header(fd, source_size, source_mtime, header);
+
+		if (fd >= 0) {
+			close(fd);
+		}
+
+		if (valid) {
+			return std::make_shared<DatasetStream<E>>(path, header.data_offset,
+					header.num_instances, header.num_inputs, header.num_outputs,
+					block_size);
+		}
+
+		if (attempt == 0) {
+			convert(file_path, path, source_size, source_mtime);
+		}
+	}
+
+	throw std::runtime_error("Could not read the dataset cache!");
+}
+
+/// @brief Computes the FNV-1a hash of a byte sequence.
+/// @param data bytes to hash
+/// @param size number of bytes
+/// @param hash hash to continue with
+/// @return 64 bit hash
+template<class E>
+uint64_t DatasetCache<E>::checksum(const void *data, std::size_t size,
+		uint64_t hash) {
+	const unsigned char *bytes = static_cast<const unsigned char*>(data);
+
+	for (std::size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+/// @brief Computes the checksum of a header with the header checksum field zeroed.
+template<class E>
+uint64_t DatasetCache<E>::header_checksum(Header header) {
+	header.header_checksum = 0;
+	return checksum(&header, sizeof(Header));
+}
+
+template<class E>
+uint32_t DatasetCache<E>::type_flags() {
+	uint32_t flags = 0;
+
+	if (std::is_floating_point<E>::value) {
+		flags |= FLOATING;
+	}
+
+	if (std::is_signed<E>::value) {
+		flags |= SIGNED;
+	}
+
+	return flags;
+}
+
+/// @brief Reads size and modification time of the benchmark file.
+/// @return false if the file cannot be accessed
+template<class E>
+bool DatasetCache<E>::stat_source(const std::string &file_path,
+		uint64_t &size, int64_t &mtime) {
+	struct stat info;
+
+	if (stat(file_path.c_str(), &info) != 0) {
+		return false;
+	}
+
+	size = info.st_size;
+	mtime = (int64_t) info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+
+	return true;
+}
+
+/// @brief Writes a byte sequence at an offset of a file.
+/// @return false if the bytes could not be written
+template<class E>
+bool DatasetCache<E>::write_at(int fd, const void *data, std::size_t size,
+		uint64_t offset) {
+	const char *bytes = static_cast<const char*>(data);
+
+	while (size > 0) {
+		ssize_t written = pwrite(fd, bytes, size, offset);
+
+		if (written <= 0) {
+			return false;
+		}
+
+		bytes += written;
+		offset += written;
+		size -= written;
+	}
+
+	return true;
+}
+
+/// @brief Creates the header of a cache file without the checksums.
+template<class E>
+typename DatasetCache<E>::Header DatasetCache<E>::make_header(int num_inputs,
+		int num_outputs, uint64_t num_instances, uint64_t source_size,
+		int64_t source_mtime) {
+
+	Header header;
+	std::memset(&header, 0, sizeof(Header));
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+
+	header.version = VERSION;
+	header.type_size = sizeof(E);
+	header.type_flags = type_flags();
+	header.num_inputs = num_inputs;
+	header.num_outputs = num_outputs;
+	header.num_instances = num_instances;
+	header.data_offset = (sizeof(Header) + 63) / 64 * 64;
+	header.source_size = source_size;
+	header.source_mtime = source_mtime;
+
+	return header;
+}
+
+/// @brief Reads the header of a cache file and checks it against the benchmark file.
+/// @param fd descriptor of the cache file
+/// @param source_size size of the benchmark file
+/// @param source_mtime modification time of the benchmark file
+/// @param header header that is read
+/// @return true if the cache is valid for the benchmark file
+template<class E>
+bool DatasetCache<E>::read_header(int fd, uint64_t source_size,
+		int64_t source_mtime, Header &header) {
+
+	struct stat info;
+
+	bool valid = fstat(fd, &info) == 0
+			&& pread(fd, &header, sizeof(Header), 0) == (ssize_t) sizeof(Header);
+
+	return valid && std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+			&& header.version == VERSION
+			&& header.header_checksum == header_checksum(header)
+			&& header.type_size == sizeof(E)
+			&& header.type_flags == type_flags()
+			&& header.source_size == source_size
+			&& header.source_mtime == source_mtime
+			&& header.num_instances > 0
+			&& header.data_offset % alignof(E) == 0
+			&& (uint64_t) info.st_size
+					== header.data_offset
+							+ (uint64_t) (header.num_inputs + header.num_outputs)
+									* header.num_instances * sizeof(E);
+}
+
+/// @brief Maps a cache file into memory if it matches the benchmark file.
+/// @details The mapping is released when the last reference to the data is gone.
+/// @return shared pointer to the dataset or nullptr if the cache is missing or invalid
+template<class E>
+std::shared_ptr<Dataset<E>> DatasetCache<E>::map(const std::string &cache_path,
+		uint64_t source_size, int64_t source_mtime, bool verify) {
+
+	int fd = open(cache_path.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+		return nullptr;
+	}
+
+	Header header;
+
+	if (!read_header(fd, source_size, source_mtime, header)) {
+		close(fd);
+		return nullptr;
+	}
+
+	std::size_t length = header.data_offset
+			+ (std::size_t) (header.num_inputs + header.num_outputs)
+					* header.num_instances * sizeof(E);
+	void *memory = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if (memory == MAP_FAILED) {
+		return nullptr;
+	}
+
+	std::shared_ptr<const E> data(
+			reinterpret_cast<const E*>(static_cast<char*>(memory)
+					+ header.data_offset), [memory, length](const E*) {
+				munmap(memory, length);
+			});
+
+	std::shared_ptr<Dataset<E>> dataset = std::make_shared<Dataset<E>>(data,
+			header.num_instances, header.num_inputs, header.num_outputs);
+
+	if (verify
+			&& checksum(dataset->get_data(), dataset->size() * sizeof(E))
+					!= header.data_checksum) {
+		return nullptr;
+	}
+
+	return dataset;
+}
+
+/// @brief Writes the cache file of a dataset.
+/// @details The cache is written to a temporary file that is renamed afterwards,
+/// so concurrent runs never map a partially written cache. Failures are ignored
+/// since the cache is only an optimization.
+template<class E>
+void DatasetCache<E>::write(const std::string &cache_path,
+		const Dataset<E> &dataset, uint64_t source_size, int64_t source_mtime) {
+
+	Header header = make_header(dataset.get_num_inputs(),
+			dataset.get_num_outputs(), dataset.get_num_instances(), source_size,
+			source_mtime);
+	header.data_checksum = checksum(dataset.get_data(),
+			dataset.size() * sizeof(E));
+	header.header_checksum = header_checksum(header);
+
+	std::string tmp_path = cache_path + ".tmp." + std::to_string(getpid());
+	std::ofstream ofs(tmp_path, std::ofstream::binary | std::ofstream::trunc);
+
+	if (!ofs.is_open()) {
+		return;
+	}
+
+	char padding[64] = { };
+
+	ofs.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+	ofs.write(padding, header.data_offset - sizeof(Header));
+	ofs.write(reinterpret_cast<const char*>(dataset.get_data()),
+			dataset.size() * sizeof(E));
+	ofs.close();
+
+	if (ofs.fail() || std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+		std::remove(tmp_path.c_str());
+	}
+}
+
+/// @brief Converts a benchmark file blockwise into a cache file.
+/// @details The instances of a block are transposed in memory and written to their
+/// positions in the columns of the file. The data checksum is computed by reading 
+/// the columns back afterwards.
+/// @param file_path path of the benchmark file
+/// @param cache_path path of the cache file
+/// @param source_size size of the benchmark file
+/// @param source_mtime modification time of the benchmark file
+template<class E>
+void DatasetCache<E>::convert(const std::string &file_path,
+		const std::string &cache_path, uint64_t source_size,
+		int64_t source_mtime) {
+
+	BenchmarkFileReader<E> reader;
+	reader.open_benchmark_file(file_path);
+
+	int num_inputs = reader.get_num_inputs();
+	int num_outputs = reader.get_num_outputs();
+	int num_instances = reader.get_num_instances();
+	int num_columns = num_inputs + num_outputs;
+
+	if (num_instances <= 0 || num_inputs <= 0 || num_outputs <= 0) {
+		throw std::runtime_error("Error while reading benchmark file!");
+	}
+
+	Header header = make_header(num_inputs, num_outputs, num_instances,
+			source_size, source_mtime);
+
+	std::string tmp_path = cache_path + ".tmp." + std::to_string(getpid());
+	int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+	if (fd < 0) {
+		throw std::runtime_error("Could not write the dataset cache!");
+	}
+
+	int rows = std::min(CONVERSION_BLOCK_SIZE, num_instances);
+	std::vector<E> values((std::size_t) num_columns * rows);
+	std::vector<E> input_chunk;
+	std::vector<E> output_chunk;
+
+	bool read_error = false;
+	bool write_error = false;
+
+	for (int begin = 0; begin < num_instances && !read_error && !write_error;
+			begin += rows) {
+		int size = std::min(rows, num_instances - begin);
+
+		for (int i = 0; i < size && !read_error; i++) {
+			read_error = !reader.read_instance(input_chunk, output_chunk);
+
+			for (int j = 0; j < num_inputs && !read_error; j++) {
+				values[(std::size_t) j * rows + i] = input_chunk[j];
+			}
+
+			for (int j = 0; j < num_outputs && !read_error; j++) {
+				values[(std::size_t) (num_inputs + j) * rows + i] =
+						output_chunk[j];
+			}
+		}
+
+		for (int j = 0; j < num_columns && !read_error && !write_error; j++) {
+			write_error = !write_at(fd, values.data() + (std::size_t) j * rows,
+					size * sizeof(E),
+					header.data_offset
+							+ ((uint64_t) j * num_instances + begin) * sizeof(E));
+		}
+	}
+
+	uint64_t hash = checksum(nullptr, 0);
+	uint64_t remaining = (uint64_t) num_columns * num_instances * sizeof(E);
+	uint64_t offset = header.data_offset;
+	std::vector<char> bytes(1 << 20);
+
+	while (remaining > 0 && !read_error && !write_error) {
+		ssize_t received = pread(fd, bytes.data(),
+				std::min<uint64_t>(remaining, bytes.size()), offset);
+
+		if (received <= 0) {
+			write_error = true;
+			break;
+		}
+
+		hash = checksum(bytes.data(), received, hash);
+		offset += received;
+		remaining -= received;
+	}
+
+	header.data_checksum = hash;
+	header.header_checksum = header_checksum(header);
+
+	write_error = write_error || read_error
+			|| !write_at(fd, &header, sizeof(Header), 0);
+	write_error = close(fd) != 0 || write_error;
+
+	if (read_error || write_error
+			|| std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+		std::remove(tmp_path.c_str());
+
+		if (read_error) {
+			throw std::runtime_error("Error while reading benchmark file!");
+		}
+
+		throw std::runtime_error("Could not write the dataset cache!");
+	}
+}
+
+#endif /* BENCHMARK_DATASETCACHE_H_ */
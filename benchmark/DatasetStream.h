@@ -0,0 +1,294 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: DatasetStream.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef BENCHMARK_DATASETSTREAM_H_
+#define BENCHMARK_DATASETSTREAM_H_
+
+#include <string>
+#include <memory>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+#include <cstdint>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "Dataset.h"
+
+/// @brief Reads a dataset cache file in blocks of consecutive instances.
+/// @details Used for datasets that do not fit into memory. A pass over the dataset
+/// is started with rewind, after which a background thread reads the blocks in order
+/// while the caller evaluates the previous ones. Each block is provided as a dataset
+/// of its own in the column-major layout. At most PREFETCH_BLOCKS blocks are kept
+/// ahead of the caller, so the memory use is bounded by the block size. A copy of a
+/// stream reads the same file with its own thread and file descriptor.
+/// @tparam E Evaluation Type
+template<class E>
+class DatasetStream {
+private:
+	static constexpr int PREFETCH_BLOCKS = 2;
+
+	std::string cache_path;
+	uint64_t data_offset;
+
+	int num_instances;
+	int num_inputs;
+	int num_outputs;
+	int block_size;
+
+	int fd;
+
+	std::thread reader;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::shared_ptr<const Dataset<E>>> blocks;
+	bool finished;
+	bool stopped;
+	std::string error;
+
+	void read_blocks();
+	std::shared_ptr<const Dataset<E>> read_block(int begin);
+
+public:
+	DatasetStream(const std::string &p_cache_path, uint64_t p_data_offset,
+			int p_num_instances, int p_num_inputs, int p_num_outputs,
+			int p_block_size);
+	DatasetStream(const DatasetStream &stream);
+	virtual ~DatasetStream();
+
+	void rewind();
+	std::shared_ptr<const Dataset<E>> next();
+	void stop();
+
+	int get_num_instances() const;
+	int get_num_inputs() const;
+	int get_num_outputs() const;
+	int get_block_size() const;
+	int get_num_blocks() const;
+};
+
+/// @brief Constructor that describes the data section of a cache file.
+/// @details The file is opened with the first pass.
+/// @param p_cache_path path of the cache file
+/// @param p_data_offset offset of the column-major data in bytes
+/// @param p_num_instances number of instances
+/// @param p_num_inputs number of input variables
+/// @param p_num_outputs number of output variables
+/// @param p_block_size number of instances per block
+template<class E>
+DatasetStream<E>::DatasetStream(const std::string &p_cache_path,
+		uint64_t p_data_offset, int p_num_instances, int p_num_inputs,
+		int p_num_outputs, int p_block_size) {
+
+	if (p_num_instances <= 0 || p_block_size <= 0) {
+		throw std::invalid_argument("Invalid dimension of the dataset stream!");
+	}
+
+	cache_path = p_cache_path;
+	data_offset = p_data_offset;
+	num_instances = p_num_instances;
+	num_inputs = p_num_inputs;
+	num_outputs = p_num_outputs;
+	block_size = std::min(p_block_size, p_num_instances);
+
+	fd = -1;
+	finished = true;
+	stopped = false;
+}
+
+/// @brief Copy constructor that creates an independent stream over the same file.
+/// @param stream stream to copy
+template<class E>
+DatasetStream<E>::DatasetStream(const DatasetStream &stream) :
+		DatasetStream<E>(stream.cache_path, stream.data_offset,
+				stream.num_instances, stream.num_inputs, stream.num_outputs,
+				stream.block_size) {
+}
+
+template<class E>
+DatasetStream<E>::~DatasetStream() {
+	this->stop();
+
+	if (fd >= 0) {
+		close(fd);
+	}
+}
+
+/// @brief Starts a new pass over the dataset.
+/// @details A pass that is still running is stopped beforehand.
+template<class E>
+void DatasetStream<E>::rewind() {
+	this->stop();
+
+	if (fd < 0) {
+		fd = open(cache_path.c_str(), O_RDONLY);
+
+		if (fd < 0) {
+			throw std::runtime_error("Could not open the dataset cache!");
+		}
+	}
+
+	blocks.clear();
+	finished = false;
+	stopped = false;
+	error.clear();
+
+	reader = std::thread(&DatasetStream<E>::read_blocks, this);
+}
+
+/// @brief Returns the next block of the current pass.
+/// @details Waits until the block has been read.
+/// @return shared pointer to the block or nullptr at the end of the pass
+template<class E>
+std::shared_ptr<const Dataset<E>> DatasetStream<E>::next() {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	condition.wait(lock, [this] {
+		return !blocks.empty() || finished;
+	});
+
+	if (!error.empty()) {
+		throw std::runtime_error(error);
+	}
+
+	if (blocks.empty()) {
+		return nullptr;
+	}
+
+	std::shared_ptr<const Dataset<E>> block = blocks.front();
+	blocks.pop_front();
+
+	condition.notify_all();
+
+	return block;
+}
+
+/// @brief Stops the current pass and waits for the background thread.
+template<class E>
+void DatasetStream<E>::stop() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopped = true;
+	}
+
+	condition.notify_all();
+
+	if (reader.joinable()) {
+		reader.join();
+	}
+
+	blocks.clear();
+}
+
+/// @brief Reads the blocks of a pass in order, running on the background thread.
+template<class E>
+void DatasetStream<E>::read_blocks() {
+	for (int begin = 0; begin < num_instances; begin += block_size) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			condition.wait(lock, [this] {
+				return (int) blocks.size() < PREFETCH_BLOCKS || stopped;
+			});
+
+			if (stopped) {
+				break;
+			}
+		}
+
+		std::shared_ptr<const Dataset<E>> block;
+
+		try {
+			block = this->read_block(begin);
+		} catch (const std::exception &e) {
+			std::lock_guard<std::mutex> lock(mutex);
+			error = e.what();
+			break;
+		}
+
+		std::lock_guard<std::mutex> lock(mutex);
+		blocks.push_back(block);
+		condition.notify_all();
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	finished = true;
+	condition.notify_all();
+}
+
+/// @brief Reads the instances of a block from each column of the file.
+/// @param begin first instance of the block
+/// @return shared pointer to the block
+template<class E>
+std::shared_ptr<const Dataset<E>> DatasetStream<E>::read_block(int begin) {
+	int size = std::min(block_size, num_instances - begin);
+	int num_columns = num_inputs + num_outputs;
+
+	std::shared_ptr<E[]> values(new E[(std::size_t) num_columns * size]);
+
+	for (int j = 0; j < num_columns; j++) {
+		char *target = reinterpret_cast<char*>(values.get()
+				+ (std::size_t) j * size);
+		std::size_t remaining = (std::size_t) size * sizeof(E);
+		off_t offset = data_offset
+				+ ((uint64_t) j * num_instances + begin) * sizeof(E);
+
+		while (remaining > 0) {
+			ssize_t received = pread(fd, target, remaining, offset);
+
+			if (received <= 0) {
+				throw std::runtime_error("Could not read the dataset cache!");
+			}
+
+			target += received;
+			offset += received;
+			remaining -= received;
+		}
+	}
+
+	return std::make_shared<const Dataset<E>>(
+			std::shared_ptr<const E>(values, values.get()), size, num_inputs,
+			num_outputs);
+}
+
+template<class E>
+int DatasetStream<E>::get_num_instances() const {
+	return this->num_instances;
+}
+
+template<class E>
+int DatasetStream<E>::get_num_inputs() const {
+	return this->num_inputs;
+}
+
+template<class E>
+int DatasetStream<E>::get_num_outputs() const {
+	return this->num_outputs;
+}
+
+template<class E>
+int DatasetStream<E>::get_block_size() const {
+	return this->block_size;
+}
+
+/// @brief Returns the number of blocks of a pass.
+/// @return number of blocks
+template<class E>
+int DatasetStream<E>::get_num_blocks() const {
+	return (this->num_instances + this->block_size - 1) / this->block_size;
+}
+
+#endif /* BENCHMARK_DATASETSTREAM_H_ */
@@ -27,6 +27,12 @@
 #include "initializer/LogicSynthesisInitializer.h"
 #include "initializer/BlackBoxInitializer.h"
 #include "random/Random.h"
+#include "checkpoint/Preemption.h"
+#include "checkpoint/Manifest.h"
+
+#ifdef CGP_ALLOC_COUNTERS
+#include "profiling/AllocHooks.h"
+#endif
 
 typedef unsigned int PROBLEM_TYPE;
 
@@ -34,7 +40,7 @@ void usage(const char *self) {
 	std::cout << "usage: DATAFILE PARFILE [opt]CHECKPOINTFILE <options>"
 			<< std::endl;
 	std::cout
-			<< "-a <value>          search algorithm: 0 - one-plus-lambda; 1 = mu-plus-lambda"
+			<< "-a <value>          search algorithm: 0 - one-plus-lambda; 1 = mu-plus-lambda; 2 = async-steady-state"
 			<< std::endl;
 	std::cout << "-b <value>          levels back" << std::endl;
 	std::cout << "-n <value>          number of function nodes" << std::endl;
@@ -58,6 +64,8 @@ void usage(const char *self) {
 	std::cout << "-2 <value>          max duplication depth" << std::endl;
 	std::cout << "-3 <value>          inversion rate" << std::endl;
 	std::cout << "-4 <value>          max inversion depth" << std::endl;
+	std::cout << "-x <command>        external evaluator command" << std::endl;
+	std::cout << "-u <path>           metrics socket path" << std::endl;
 	exit(1);
 }
 
@@ -73,6 +81,8 @@ int main(int argcc, char **argvv, char **envp) {
 	std::string param_file = argvv[2];
 
 	std::string checkpoint_file;
+	std::string external_evaluator;
+	std::string metrics_socket;
 	std::string s;
 
 	int num_nodes = -1;
@@ -122,7 +132,8 @@ int main(int argcc, char **argvv, char **envp) {
 
 	if (argvv[3]) {
 		s = argvv[3];
-		if (s.find(".checkpoint") != std::string::npos) {
+		if (s.find(".checkpoint") != std::string::npos
+				|| Manifest::is_manifest(s)) {
 			checkpoint_file = s;
 		}
 	}
@@ -132,7 +143,7 @@ int main(int argcc, char **argvv, char **envp) {
 	// ---------------------------------------------------------------------------------------
 	char opt;
 	while ((opt = getopt(argcc, argvv,
-			"a:n:v:z:c:i:o:f:r:m:p:l:b:e:g:j:s:1:2:3:4")) != -1) {
+			"a:n:v:z:c:i:o:f:r:m:p:l:b:e:g:j:s:1:2:3:4:x:u:")) != -1) {
 		switch (opt) {
 
 		case 'a':
@@ -219,6 +230,14 @@ int main(int argcc, char **argvv, char **envp) {
 			max_inversion_depth = atoi(optarg);
 			break;
 
+		case 'x':
+			external_evaluator = optarg;
+			break;
+
+		case 'u':
+			metrics_socket = optarg;
+			break;
+
 		default:
 			usage(*argvv);
 			exit(1);
@@ -266,6 +285,15 @@ int main(int argcc, char **argvv, char **envp) {
 			max_duplication_depth, inversion_rate, max_inversion_depth,
 			crossover_rate, levels_back);
 
+	if (!external_evaluator.empty()) {
+		initializer->get_parameters()->set_external_evaluator(
+				external_evaluator);
+	}
+
+	if (!metrics_socket.empty()) {
+		initializer->get_parameters()->set_metrics_socket(metrics_socket);
+	}
+
 
 	// ---------------------------------------------------------------------------------------
 
@@ -280,9 +308,12 @@ int main(int argcc, char **argvv, char **envp) {
 	initializer->init_algorithm();
 
 
-	// Check for a checkpoint file
+	// Check for a checkpoint file, the checkpoints listed in a manifest
+	// are loaded by the jobs of the resumed experiment
 	// ---------------------------------------------------------------------------------------
-	if (checkpoint_file != "")
+	bool manifest = Manifest::is_manifest(checkpoint_file);
+
+	if (checkpoint_file != "" && !manifest)
 		initializer->init_checkpoint_file(checkpoint_file);
 
 	// Create the evolver
@@ -291,9 +322,21 @@ int main(int argcc, char **argvv, char **envp) {
 			std::make_shared<Evolver<EVALUATION_TYPE, GENOME_TYPE, FITNESS_TYPE>>(
 					initializer);
 
-	if (checkpoint_file == "") {
-		evolver->run();
-	} else {
-		evolver->resume(checkpoint_file);
+	// A termination request stops the jobs after the current generation 
+	// and writes checkpoints and a manifest that can be resumed
+	// ---------------------------------------------------------------------------------------
+	Preemption::install();
+
+	try {
+		if (checkpoint_file == "") {
+			evolver->run();
+		} else if (manifest) {
+			evolver->resume_experiment(checkpoint_file);
+		} else {
+			evolver->resume(checkpoint_file);
+		}
+	} catch (const PreemptedException &e) {
+		std::cout << e.what() << std::endl;
+		return Preemption::EXIT_CODE;
 	}
 }
@@ -19,15 +19,44 @@
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <future>
+#include <functional>
+#include <vector>
+#include <sstream>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <cerrno>
+#include <cstdio>
 
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "CheckpointState.h"
 #include "../algorithm/EvolutionaryAlgorithm.h"
 #include "../parameters/Parameters.h"
 #include "../population/AbstractPopulation.h"
 #include "../random/Random.h"
+#include "../profiling/Tracer.h"
 
 using namespace std::chrono;
 
 /// @brief Handles reading and writing checkpoints for the evolutionary algorithm.
+/// @details Checkpoints are written in a versioned binary format by default. The file 
+/// starts with a header that describes the configuration, followed by the evaluation 
+/// status and fitness of each individual, the state of the algorithm and the random 
+/// generator, the constants and the genomes, so a job can be resumed exactly. Integer genomes
+/// are delta-encoded against the genome of the preceding individual, which is often 
+/// its parent or a sibling, and stored as zigzag varints, so unchanged genes take a 
+/// single byte. A FNV-1a checksum covers the header and the payload. The genomes are 
+/// decoded straight into the genome storage of the individuals. The text format remains 
+/// available as export option and both formats are recognized when loading. 
+///
+/// Writing is split into taking a snapshot and serializing it. The snapshot references the 
+/// genomes, which are not modified after breeding, and copies the fitness values and 
+/// constants, so the algorithm can continue while the snapshot is serialized in the 
+/// background. Each file is written to a temporary file, synced to disk and renamed, 
+/// so a crash never leaves a partially written checkpoint behind.
 /// @tparam E Evaluation Type
 /// @tparam G Genotype Type
 /// @tparam F Fitness Type 
@@ -36,48 +65,149 @@ class Checkpoint {
 private:
 	std::shared_ptr<Parameters> parameters;
 	std::string dir_name;
+	int job;
+	std::future<void> pending;
+	std::shared_ptr<Tracer> tracer;
+
+	static constexpr char MAGIC[8] = { 'C', 'G', 'P', 'C', 'K', 'P', 'T', '\0' };
+	static constexpr uint32_t VERSION = 2;
+	static constexpr uint32_t DELTA_ENCODED = 1;
+	static constexpr uint32_t PENDING_BATCH = 2;
+
+	/// @brief Header of the binary checkpoint format.
+	struct Header {
+		char magic[8];
+		uint32_t version;
+		uint32_t flags;
+		uint32_t genome_type_size;
+		uint32_t evaluation_type_size;
+		uint32_t fitness_type_size;
+		int32_t parent_index;
+		int64_t generation_number;
+		int64_t fitness_evaluations;
+		int64_t global_seed;
+		uint64_t population_size;
+		uint64_t genome_size;
+		uint64_t num_constants;
+		uint64_t random_state_size;
+		uint64_t genome_section_size;
+		uint64_t checksum;
+	};
+
+	/// @brief In-memory state of the population at the time of a checkpoint.
+	struct Snapshot {
+		CheckpointState<F> state;
+		long long global_seed;
+		int genome_size;
+		std::vector<std::shared_ptr<G[]>> genomes;
+		std::vector<F> fitness;
+		std::vector<char> evaluated;
+		std::vector<E> constants;
+	};
+
+	Snapshot snapshot(std::shared_ptr<AbstractPopulation<G, F>> population,
+			std::shared_ptr<std::vector<E>> constants,
+			const CheckpointState<F> &state);
+	std::string write_snapshot(const Snapshot &snapshot);
+	void write_binary(std::vector<char> &buffer, const Snapshot &snapshot);
+	void write_text(std::vector<char> &buffer, const Snapshot &snapshot);
+	void write_file(const std::string &file_path,
+			const std::vector<char> &buffer);
+	CheckpointState<F> load_binary(std::ifstream &ifs,
+			std::shared_ptr<AbstractPopulation<G, F>> population,
+			std::shared_ptr<std::vector<E>> constants,
+			std::shared_ptr<Random> random);
+	CheckpointState<F> load_text(std::ifstream &ifs,
+			std::shared_ptr<AbstractPopulation<G, F>> population,
+			std::shared_ptr<std::vector<E>> constants,
+			std::shared_ptr<Random> random);
+
+	static void put_varint(std::vector<char> &buffer, uint64_t value);
+	static uint64_t get_varint(const char *&pos, const char *end);
+	static uint64_t checksum(const void *data, std::size_t size,
+			uint64_t hash = 14695981039346656037ULL);
 public:
-	Checkpoint(std::shared_ptr<Parameters> p_parameters);
+	Checkpoint(std::shared_ptr<Parameters> p_parameters, int p_job = 0);
 	virtual ~Checkpoint() = default;
-	void write(std::shared_ptr<AbstractPopulation<G, F>> population,
-			std::shared_ptr<std::vector<E>> constants, int generation_number);
-	int load(std::shared_ptr<AbstractPopulation<G, F>> population,
+	std::string write(std::shared_ptr<AbstractPopulation<G, F>> population,
+			std::shared_ptr<std::vector<E>> constants,
+			const CheckpointState<F> &state);
+	void write_async(std::shared_ptr<AbstractPopulation<G, F>> population,
+			std::shared_ptr<std::vector<E>> constants,
+			const CheckpointState<F> &state,
+			std::function<void()> on_written = nullptr);
+	void wait();
+	CheckpointState<F> load(std::shared_ptr<AbstractPopulation<G, F>> population,
 			std::shared_ptr<std::vector<E>> constants,
 			std::shared_ptr<Random> random, std::string &checkpoint_file_path);
-	void create_dir();
-	void init();
+	void create_dir(int job = 0);
+	void init(int job = 0);
+	bool is_initialized() const;
+	int get_job() const;
+	void set_tracer(std::shared_ptr<Tracer> p_tracer);
 	std::vector<std::string> split_genome(string genome_str);
 };
 
+/// @param p_parameters shared pointer to the parameter object
+/// @param p_job job number or 0 if the job runs exclusively
 template<class E, class G, class F>
-Checkpoint<E, G, F>::Checkpoint(std::shared_ptr<Parameters> p_parameters) {
+Checkpoint<E, G, F>::Checkpoint(std::shared_ptr<Parameters> p_parameters,
+		int p_job) {
 	if (p_parameters != nullptr) {
 		this->parameters = p_parameters;
 	} else {
 		throw std::invalid_argument(
 				"Nullpointer exception in checkpoint class!");
 	}
+
+	this->job = p_job;
 }
 
 template<class E, class G, class F>
-void Checkpoint<E, G, F>::init() {
-		create_dir();
+void Checkpoint<E, G, F>::init(int job) {
+		create_dir(job);
+}
+
+/// @brief Returns whether the checkpoint directory has been created.
+/// @return true if the directory exists
+template<class E, class G, class F>
+bool Checkpoint<E, G, F>::is_initialized() const {
+	return !this->dir_name.empty();
+}
+
+template<class E, class G, class F>
+int Checkpoint<E, G, F>::get_job() const {
+	return this->job;
+}
+
+/// @brief Sets the tracer the checkpoint writes are recorded with.
+/// @param p_tracer shared pointer to the tracer or nullptr to disable tracing
+template<class E, class G, class F>
+void Checkpoint<E, G, F>::set_tracer(std::shared_ptr<Tracer> p_tracer) {
+	this->tracer = p_tracer;
 }
 
 
 /// @brief Creates a directory for the checkpoint using the current timestamp.
 /// @details Concatenates the checkpoint file directory from the Parameters object with 
-/// the current timestamp to create the directory path.
+/// the current timestamp to create the directory path. Jobs that run concurrently 
+/// pass their job number which is appended to keep the directories apart. 
+/// @param job job number or 0 if the job runs exclusively
 template<class E, class G, class F>
-void Checkpoint<E, G, F>::create_dir() {
+void Checkpoint<E, G, F>::create_dir(int job) {
 	std::stringstream ss;
 	uint64_t tstamp = duration_cast<milliseconds>(
 			system_clock::now().time_since_epoch()).count();
-	ss << this->parameters->CHECKPOINT_FILE_DIR << tstamp;
-	std::filesystem::create_directories(ss.str());
-	ss.str("");
 	ss << tstamp;
+
+	if (job > 0) {
+		ss << "-job" << job;
+	}
+
 	this->dir_name = ss.str();
+	ss.str("");
+	ss << this->parameters->CHECKPOINT_FILE_DIR << this->dir_name;
+	std::filesystem::create_directories(ss.str());
 }
 
 /// @brief Writes the data to a file.
@@ -85,53 +215,452 @@ void Checkpoint<E, G, F>::create_dir() {
 /// global seed, genomes of each individual in the population, and constants.
 /// @param population 
 /// @param constants 
-/// @param generation_number 
+/// @param state state of the algorithm
+/// @return path of the checkpoint file
+template<class E, class G, class F>
+std::string Checkpoint<E, G, F>::write(
+		std::shared_ptr<AbstractPopulation<G, F>> population,
+		std::shared_ptr<std::vector<E>> constants,
+		const CheckpointState<F> &state) {
+	this->wait();
+	return this->write_snapshot(this->snapshot(population, constants, state));
+}
+
+/// @brief Writes the checkpoint in the background.
+/// @details Takes a snapshot of the population and the constants. Serialization 
+/// and file output are then done by a background task. At most one write is in flight, 
+/// a pending write is completed first. 
+/// @param population 
+/// @param constants 
+/// @param state state of the algorithm
+/// @param on_written function that is called by the background task once the file 
+/// has been written successfully, if any
+template<class E, class G, class F>
+void Checkpoint<E, G, F>::write_async(
+		std::shared_ptr<AbstractPopulation<G, F>> population,
+		std::shared_ptr<std::vector<E>> constants,
+		const CheckpointState<F> &state, std::function<void()> on_written) {
+	this->wait();
+
+	Snapshot current = this->snapshot(population, constants, state);
+
+	this->pending = std::async(std::launch::async,
+			[this, current = std::move(current), on_written]() {
+				this->write_snapshot(current);
+
+				if (on_written) {
+					on_written();
+				}
+			});
+}
+
+/// @brief Waits until a pending background write is completed. 
+template<class E, class G, class F>
+void Checkpoint<E, G, F>::wait() {
+	if (this->pending.valid()) {
+		this->pending.get();
+	}
+}
+
+/// @brief Takes a snapshot of the population and the constants.
+/// @param population 
+/// @param constants 
+/// @param state state of the algorithm
+/// @return snapshot that is independent of later changes to the population
 template<class E, class G, class F>
-void Checkpoint<E, G, F>::write(
+typename Checkpoint<E, G, F>::Snapshot Checkpoint<E, G, F>::snapshot(
 		std::shared_ptr<AbstractPopulation<G, F>> population,
-		std::shared_ptr<std::vector<E>> constants, int generation_number) {
+		std::shared_ptr<std::vector<E>> constants,
+		const CheckpointState<F> &state) {
+	Snapshot current;
+	current.state = state;
+	current.genome_size = population->get_individual(0)->get_genome_size();
+	current.global_seed = this->parameters->get_global_seed();
+	current.constants = *constants;
+
+	for (int i = 0; i < population->size(); i++) {
+		std::shared_ptr<Individual<G, F>> individual =
+				population->get_individual(i);
+		current.genomes.push_back(individual->get_genome());
+		current.fitness.push_back(individual->get_fitness());
+		current.evaluated.push_back(individual->is_evaluated() ? 1 : 0);
+	}
+
+	return current;
+}
+
+/// @brief Serializes a snapshot to the checkpoint file. 
+/// @details The format is selected by the checkpoint format parameter.
+/// @param snapshot snapshot to serialize
+/// @return path of the checkpoint file
+template<class E, class G, class F>
+std::string Checkpoint<E, G, F>::write_snapshot(const Snapshot &snapshot) {
+	Tracer::Span span(this->tracer.get(), "Checkpoint write", "checkpoint",
+			snapshot.state.generation_number);
+
 	std::stringstream ss;
-	std::unique_ptr<std::ofstream> ofs;
+	std::vector<char> buffer;
 
-	// Write the genomes of the individuals in the population
 	ss << this->parameters->CHECKPOINT_FILE_DIR << this->dir_name << "/"
-			<< "generation-" << generation_number << ".checkpoint";
-	ofs = std::make_unique<std::ofstream>(ss.str().c_str(),
-			istream::out | ios::binary);
-	ss.str("");
-	ss << "generation_number " << generation_number << std::endl;
-	ss << "global_seed " << this->parameters->get_global_seed() << std::endl;
+			<< "generation-" << snapshot.state.generation_number << ".checkpoint";
 
-	// Write the constants
-	for (int i = 0; i < this->parameters->get_population_size(); i++) {
-		std::string genome_str = population->get_individual(i)->to_string(",");
-		ss << "genome " << genome_str << std::endl;
+	if (this->parameters->get_checkpoint_format()
+			== this->parameters->TEXT_CHECKPOINT) {
+		this->write_text(buffer, snapshot);
+	} else {
+		this->write_binary(buffer, snapshot);
+	}
+
+	this->write_file(ss.str(), buffer);
+
+	return ss.str();
+}
+
+/// @brief Serializes a snapshot in the binary format.
+/// @param buffer buffer the header and payload are appended to
+/// @param snapshot snapshot to serialize
+template<class E, class G, class F>
+void Checkpoint<E, G, F>::write_binary(std::vector<char> &buffer,
+		const Snapshot &snapshot) {
+	int genome_size = snapshot.genome_size;
+	int num_constants = this->parameters->get_num_constants();
+	std::size_t population_size = snapshot.genomes.size();
+
+	Header header { };
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.genome_type_size = sizeof(G);
+	header.evaluation_type_size = sizeof(E);
+	header.fitness_type_size = sizeof(F);
+	header.parent_index = snapshot.state.parent_index;
+	header.generation_number = snapshot.state.generation_number;
+	header.fitness_evaluations = snapshot.state.fitness_evaluations;
+	header.global_seed = snapshot.global_seed;
+	header.population_size = population_size;
+	header.genome_size = genome_size;
+	header.num_constants = num_constants;
+	header.random_state_size = snapshot.state.random_state.size();
+
+	if (snapshot.state.pending_batch) {
+		header.flags |= PENDING_BATCH;
+	}
+
+	// The header is filled in once the payload is complete
+	std::size_t header_pos = buffer.size();
+	buffer.resize(header_pos + sizeof(Header));
+	std::size_t payload_pos = buffer.size();
+
+	// Evaluation status and fitness of the individuals
+	buffer.insert(buffer.end(), snapshot.evaluated.begin(),
+			snapshot.evaluated.end());
+
+	const char *fitness = reinterpret_cast<const char*>(snapshot.fitness.data());
+	buffer.insert(buffer.end(), fitness, fitness + population_size * sizeof(F));
+
+	const char *best_fitness =
+			reinterpret_cast<const char*>(&snapshot.state.best_fitness);
+	buffer.insert(buffer.end(), best_fitness, best_fitness + sizeof(F));
+
+	for (int i = 0; i < num_constants; i++) {
+		E constant = snapshot.constants.at(i);
+		const char *bytes = reinterpret_cast<const char*>(&constant);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(E));
+	}
+
+	buffer.insert(buffer.end(), snapshot.state.random_state.begin(),
+			snapshot.state.random_state.end());
+
+	// Genomes, either delta-encoded or as raw blocks
+	std::size_t genome_pos = buffer.size();
+	bool delta_encoded = std::is_integral<G>::value
+			&& this->parameters->is_checkpoint_delta_encoding();
+
+	if (delta_encoded) {
+		header.flags |= DELTA_ENCODED;
+		buffer.reserve(buffer.size() + population_size * genome_size);
+
+		const G *previous = nullptr;
+
+		for (auto &genome_ptr : snapshot.genomes) {
+			const G *genome = genome_ptr.get();
+
+			for (int i = 0; i < genome_size; i++) {
+				int64_t delta = (int64_t) genome[i]
+						- (previous != nullptr ? (int64_t) previous[i] : 0);
+				put_varint(buffer,
+						((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63));
+			}
+
+			previous = genome;
+		}
+	} else {
+		for (auto &genome_ptr : snapshot.genomes) {
+			const char *bytes = reinterpret_cast<const char*>(genome_ptr.get());
+			buffer.insert(buffer.end(), bytes, bytes + genome_size * sizeof(G));
+		}
 	}
 
+	header.genome_section_size = buffer.size() - genome_pos;
+	header.checksum = checksum(buffer.data() + payload_pos,
+			buffer.size() - payload_pos, checksum(&header, sizeof(Header)));
+
+	std::memcpy(buffer.data() + header_pos, &header, sizeof(Header));
+}
+
+/// @brief Serializes a snapshot in the text format.
+/// @param buffer buffer the text is appended to
+/// @param snapshot snapshot to serialize
+template<class E, class G, class F>
+void Checkpoint<E, G, F>::write_text(std::vector<char> &buffer,
+		const Snapshot &snapshot) {
+	std::stringstream ss;
+	int genome_size = snapshot.genome_size;
+
+	ss << "generation_number " << snapshot.state.generation_number << std::endl;
+	ss << "global_seed " << snapshot.global_seed << std::endl;
+
+	// Write the genomes of the individuals in the population
+	for (auto &genome : snapshot.genomes) {
+		ss << "genome ";
+		for (int i = 0; i < genome_size; i++) {
+			ss << genome[i] << (i < genome_size - 1 ? "," : "");
+		}
+		ss << std::endl;
+	}
+
+	// Write the constants
 	for (int i = 0; i < this->parameters->get_num_constants(); i++) {
-		E constant = constants->at(i);
+		E constant = snapshot.constants.at(i);
 		ss << "constant " << constant << std::endl;
 	}
 
-	// Write the content of the stringstream to the file
-	*ofs << ss.rdbuf();
+	std::string text = ss.str();
+	buffer.insert(buffer.end(), text.begin(), text.end());
+}
+
+/// @brief Writes a checkpoint file atomically.
+/// @details The content is written to a temporary file which is synced to disk and 
+/// renamed to the checkpoint file afterwards. The directory is synced as well, so 
+/// the rename is persistent.
+/// @param file_path path of the checkpoint file
+/// @param buffer content of the file
+template<class E, class G, class F>
+void Checkpoint<E, G, F>::write_file(const std::string &file_path,
+		const std::vector<char> &buffer) {
+	std::string tmp_path = file_path + ".tmp";
+
+	int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	if (fd < 0) {
+		throw std::runtime_error("Error opening checkpoint file!");
+	}
+
+	const char *data = buffer.data();
+	std::size_t remaining = buffer.size();
+
+	while (remaining > 0) {
+		ssize_t written = ::write(fd, data, remaining);
+
+		if (written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		data += written;
+		remaining -= written;
+	}
+
+	bool synced = (remaining == 0 && fsync(fd) == 0);
+	close(fd);
+
+	if (!synced || std::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+		unlink(tmp_path.c_str());
+		throw std::runtime_error("Error writing checkpoint file!");
+	}
+
+	std::string dir_path =
+			std::filesystem::path(file_path).parent_path().string();
+	int dir_fd = open(dir_path.c_str(), O_RDONLY | O_DIRECTORY);
+
+	if (dir_fd >= 0) {
+		fsync(dir_fd);
+		close(dir_fd);
+	}
 }
 
 /// @brief Loads the checkpoint data from a file and initializes the population and constants accordingly.
-/// @details Takes the path to the checkpoint file as input and returns the generation number.
+/// @details Takes the path to the checkpoint file as input and returns the state of the algorithm. 
+/// The format is recognized by the magic number at the beginning of the file. 
 /// @param population 
 /// @param constants 
 /// @param random 
 /// @param checkpoint_file_path 
-/// @return 
+/// @return state of the algorithm at the time of the checkpoint
 template<class E, class G, class F>
-int Checkpoint<E, G, F>::load(
+CheckpointState<F> Checkpoint<E, G, F>::load(
 		std::shared_ptr<AbstractPopulation<G, F>> population,
 		std::shared_ptr<std::vector<E>> constants,
 		std::shared_ptr<Random> random, std::string &checkpoint_file_path) {
 	std::ifstream ifs;
 	ifs.open(checkpoint_file_path, ios_base::in | ios_base::binary);
 
+	if (!ifs.is_open()) {
+		throw std::runtime_error("Error opening checkpoint file!");
+	}
+
+	char magic[sizeof(MAGIC)] = { };
+	ifs.read(magic, sizeof(MAGIC));
+	bool binary = ifs.good() && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+
+	ifs.clear();
+	ifs.seekg(0);
+
+	if (binary) {
+		return this->load_binary(ifs, population, constants, random);
+	} else {
+		return this->load_text(ifs, population, constants, random);
+	}
+}
+
+/// @brief Loads a checkpoint in the binary format.
+/// @details Validates the header against the configuration and the checksum before 
+/// the genomes are decoded into the genome storage of the individuals. The fitness 
+/// and evaluation status are restored, so evaluated individuals are not evaluated again, 
+/// and the random generator continues from the stored state and seed.
+/// @param ifs input stream of the checkpoint file
+/// @param population 
+/// @param constants 
+/// @param random 
+/// @return exact state of the algorithm at the time of the checkpoint
+template<class E, class G, class F>
+CheckpointState<F> Checkpoint<E, G, F>::load_binary(std::ifstream &ifs,
+		std::shared_ptr<AbstractPopulation<G, F>> population,
+		std::shared_ptr<std::vector<E>> constants,
+		std::shared_ptr<Random> random) {
+	Header header;
+	ifs.read(reinterpret_cast<char*>(&header), sizeof(Header));
+
+	if (!ifs.good() || header.version != VERSION) {
+		throw std::runtime_error("Unsupported checkpoint file version!");
+	}
+
+	if (header.genome_type_size != sizeof(G)
+			|| header.evaluation_type_size != sizeof(E)
+			|| header.fitness_type_size != sizeof(F)
+			|| header.population_size
+					!= (uint64_t) population->size()
+			|| header.genome_size
+					!= (uint64_t) population->get_individual(0)->get_genome_size()) {
+		throw std::runtime_error(
+				"Checkpoint does not match the configuration!");
+	}
+
+	std::size_t population_size = header.population_size;
+	std::size_t genome_size = header.genome_size;
+	std::size_t payload_size = population_size * (1 + sizeof(F)) + sizeof(F)
+			+ header.num_constants * sizeof(E) + header.random_state_size
+			+ header.genome_section_size;
+
+	std::vector<char> payload(payload_size);
+	ifs.read(payload.data(), payload_size);
+
+	if (!ifs.good() || ifs.peek() != std::ifstream::traits_type::eof()) {
+		throw std::runtime_error("Invalid size of the checkpoint file!");
+	}
+
+	uint64_t expected = header.checksum;
+	header.checksum = 0;
+
+	if (checksum(payload.data(), payload.size(),
+			checksum(&header, sizeof(Header))) != expected) {
+		throw std::runtime_error("Checksum mismatch in checkpoint file!");
+	}
+
+	const char *pos = payload.data();
+	const char *end = payload.data() + payload.size();
+
+	const char *evaluated = pos;
+	pos += population_size;
+
+	const char *fitness = pos;
+	pos += population_size * sizeof(F);
+
+	CheckpointState<F> state;
+	state.generation_number = header.generation_number;
+	state.fitness_evaluations = header.fitness_evaluations;
+	state.parent_index = header.parent_index;
+	state.exact = true;
+	state.pending_batch = header.flags & PENDING_BATCH;
+
+	std::memcpy(&state.best_fitness, pos, sizeof(F));
+	pos += sizeof(F);
+
+	constants->resize(header.num_constants);
+	std::memcpy(constants->data(), pos, header.num_constants * sizeof(E));
+	pos += header.num_constants * sizeof(E);
+
+	state.random_state.assign(pos, header.random_state_size);
+	pos += header.random_state_size;
+
+	bool delta_encoded = header.flags & DELTA_ENCODED;
+
+	if (delta_encoded && !std::is_integral<G>::value) {
+		throw std::runtime_error(
+				"Checkpoint does not match the configuration!");
+	}
+
+	const G *previous = nullptr;
+
+	for (std::size_t k = 0; k < population_size; k++) {
+		std::shared_ptr<Individual<G, F>> individual =
+				population->get_individual(k);
+		std::shared_ptr<G[]> genome = individual->get_genome();
+
+		if (delta_encoded) {
+			for (std::size_t i = 0; i < genome_size; i++) {
+				uint64_t value = get_varint(pos, end);
+				int64_t delta = (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+				genome[i] = (G) (delta
+						+ (previous != nullptr ? (int64_t) previous[i] : 0));
+			}
+		} else {
+			if ((std::size_t) (end - pos) < genome_size * sizeof(G)) {
+				throw std::runtime_error("Invalid size of the checkpoint file!");
+			}
+			std::memcpy(genome.get(), pos, genome_size * sizeof(G));
+			pos += genome_size * sizeof(G);
+		}
+
+		previous = genome.get();
+
+		F value;
+		std::memcpy(&value, fitness + k * sizeof(F), sizeof(F));
+
+		individual->set_genome(genome);
+		individual->set_fitness(value);
+		individual->set_evaluated(evaluated[k] != 0);
+	}
+
+	this->parameters->set_global_seed(header.global_seed);
+	random->set_seed(header.global_seed);
+	random->set_state(state.random_state);
+
+	return state;
+}
+
+/// @brief Loads a checkpoint in the text format.
+/// @param ifs input stream of the checkpoint file
+/// @param population 
+/// @param constants 
+/// @param random 
+/// @return state of the algorithm that only provides the generation number
+template<class E, class G, class F>
+CheckpointState<F> Checkpoint<E, G, F>::load_text(std::ifstream &ifs,
+		std::shared_ptr<AbstractPopulation<G, F>> population,
+		std::shared_ptr<std::vector<E>> constants,
+		std::shared_ptr<Random> random) {
 	std::string parameter;
 	std::string value;
 
@@ -144,34 +673,88 @@ int Checkpoint<E, G, F>::load(
 
 	constants->clear();
 
-	if (ifs.is_open()) {
-		while (ifs >> parameter >> value) {
-			if (parameter == "generation_number") {
-				generation_number = std::stoi(value);
-			} else if (parameter == "global_seed") {
-				global_seed = std::stod(value);
-			} else if (parameter == "genome") {
-				std::vector<std::string> genome = this->split_genome(value);
-				genomes->push_back(genome);
-			} else if (parameter == "constant") {
-				try {
-					constant = std::stod(value);
-				} catch (const std::invalid_argument &e) {
-					std::cerr
-							<< "Constant type is invalid and can't be read by the checkpointer."
-					<<std::endl;
-				}
-				constants->push_back(constant);
+	while (ifs >> parameter >> value) {
+		if (parameter == "generation_number") {
+			generation_number = std::stoi(value);
+		} else if (parameter == "global_seed") {
+			global_seed = std::stod(value);
+		} else if (parameter == "genome") {
+			std::vector<std::string> genome = this->split_genome(value);
+			genomes->push_back(genome);
+		} else if (parameter == "constant") {
+			try {
+				constant = std::stod(value);
+			} catch (const std::invalid_argument &e) {
+				std::cerr
+						<< "Constant type is invalid and can't be read by the checkpointer."
+				<<std::endl;
 			}
+			constants->push_back(constant);
 		}
-	} else {
-		throw std::runtime_error("Error opening checkpoint file!");
 	}
 
 	random->set_seed(global_seed);
 	population->init_from_checkpoint(genomes);
 
-	return generation_number;
+	CheckpointState<F> state;
+	state.generation_number = generation_number;
+
+	return state;
+}
+
+/// @brief Appends an unsigned integer in the LEB128 varint encoding.
+/// @param buffer buffer to append to
+/// @param value value to encode
+template<class E, class G, class F>
+void Checkpoint<E, G, F>::put_varint(std::vector<char> &buffer,
+		uint64_t value) {
+	while (value >= 0x80) {
+		buffer.push_back((char) ((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back((char) value);
+}
+
+/// @brief Reads an unsigned integer in the LEB128 varint encoding.
+/// @param pos read position that is advanced past the value
+/// @param end end of the buffer
+/// @return decoded value
+template<class E, class G, class F>
+uint64_t Checkpoint<E, G, F>::get_varint(const char *&pos, const char *end) {
+	uint64_t value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (pos == end) {
+			break;
+		}
+
+		uint8_t byte = (uint8_t) *pos++;
+		value |= (uint64_t) (byte & 0x7F) << shift;
+
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+
+	throw std::runtime_error("Invalid genome encoding in checkpoint file!");
+}
+
+/// @brief Computes the FNV-1a hash of a byte sequence.
+/// @param data pointer to the bytes
+/// @param size number of bytes
+/// @param hash hash to continue from
+/// @return hash value
+template<class E, class G, class F>
+uint64_t Checkpoint<E, G, F>::checksum(const void *data, std::size_t size,
+		uint64_t hash) {
+	const unsigned char *bytes = static_cast<const unsigned char*>(data);
+
+	for (std::size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
 }
 
 /// @brief Function takes the geome str and splits it into substrings 
@@ -0,0 +1,36 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: CheckpointState.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+#ifndef CHECKPOINT_CHECKPOINTSTATE_H_
+#define CHECKPOINT_CHECKPOINTSTATE_H_
+
+#include <string>
+
+/// @brief State of the evolutionary algorithm that is stored in a checkpoint.
+/// @details Besides the population and the constants, the counters of the algorithm
+/// and the state of the random generator are needed to continue a job exactly
+/// where the checkpoint has been taken. Checkpoints in the text format only
+/// provide the generation number, which is indicated by the exact flag. The pending batch
+/// flag indicates that the offspring slots of the population hold a batch that has been
+/// bred but not yet evaluated, which is the case for the pipelined evaluation.
+/// @tparam F Fitness Type
+template<class F>
+struct CheckpointState {
+	int generation_number = 0;
+	int fitness_evaluations = 0;
+	int parent_index = -1;
+	F best_fitness { };
+	std::string random_state;
+	bool exact = false;
+	bool pending_batch = false;
+};
+
+#endif /* CHECKPOINT_CHECKPOINTSTATE_H_ */
@@ -0,0 +1,175 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: Manifest.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef CHECKPOINT_MANIFEST_H_
+#define CHECKPOINT_MANIFEST_H_
+
+#include <map>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/// @brief Describes an experiment that has been stopped by a termination request.
+/// @details Each job that was running at the time of the request has written a checkpoint,
+/// the jobs that have been completed before only left their report behind and the remaining
+/// jobs have not been started yet. The manifest stores the number of jobs and the global seed
+/// the seeds of the jobs are derived from, together with the checkpoint file of each running
+/// job and the report of each completed job, so the experiment can be resumed as a whole.
+/// The manifest is a text file with one entry per line.
+class Manifest {
+private:
+	int num_jobs = 0;
+	long long global_seed = 0;
+	std::map<int, std::string> checkpoints;
+	std::map<int, std::string> reports;
+
+public:
+	static inline const std::string EXTENSION = ".manifest";
+
+	Manifest() = default;
+
+	Manifest(int p_num_jobs, long long p_global_seed) :
+			num_jobs(p_num_jobs), global_seed(p_global_seed) {
+	}
+
+	/// @brief Returns whether a file passed to CGP++ is a manifest.
+	/// @param file_path path of the file
+	/// @return true if the file has the manifest extension
+	static bool is_manifest(const std::string &file_path) {
+		return file_path.size() > EXTENSION.size()
+				&& file_path.compare(file_path.size() - EXTENSION.size(),
+						EXTENSION.size(), EXTENSION) == 0;
+	}
+
+	/// @brief Adds the checkpoint of a job that has been stopped.
+	/// @param job job number
+	/// @param checkpoint_file path of the checkpoint file of the job
+	void add_checkpoint(int job, const std::string &checkpoint_file) {
+		this->checkpoints[job] = checkpoint_file;
+	}
+
+	/// @brief Adds the report of a job that has been completed.
+	/// @param job job number
+	/// @param report report of the job with or without the trailing newline
+	void add_report(int job, const std::string &report) {
+		std::string line = report;
+		if (!line.empty() && line.back() == '\n') {
+			line.pop_back();
+		}
+		this->reports[job] = line;
+	}
+
+	/// @brief Writes the manifest to a file.
+	/// @param file_path path of the manifest file
+	void write(const std::string &file_path) const {
+		std::ofstream ofs(file_path, std::ofstream::out | std::ofstream::trunc);
+
+		if (!ofs.is_open()) {
+			throw std::runtime_error("Error opening manifest file!");
+		}
+
+		ofs << "num_jobs " << this->num_jobs << std::endl;
+		ofs << "global_seed " << this->global_seed << std::endl;
+
+		for (auto &entry : this->checkpoints) {
+			ofs << "checkpoint " << entry.first << " " << entry.second
+					<< std::endl;
+		}
+
+		for (auto &entry : this->reports) {
+			ofs << "report " << entry.first << " " << entry.second << std::endl;
+		}
+
+		if (!ofs.good()) {
+			throw std::runtime_error("Error writing manifest file!");
+		}
+	}
+
+	/// @brief Reads a manifest from a file.
+	/// @param file_path path of the manifest file
+	void load(const std::string &file_path) {
+		std::ifstream ifs(file_path);
+
+		if (!ifs.is_open()) {
+			throw std::runtime_error("Error opening manifest file!");
+		}
+
+		std::string line;
+
+		while (std::getline(ifs, line)) {
+			std::stringstream ss(line);
+			std::string key;
+			ss >> key;
+
+			bool valid = true;
+
+			if (key == "num_jobs") {
+				valid = static_cast<bool>(ss >> this->num_jobs);
+			} else if (key == "global_seed") {
+				valid = static_cast<bool>(ss >> this->global_seed);
+			} else if (key == "checkpoint" || key == "report") {
+				int job;
+				valid = static_cast<bool>(ss >> job);
+
+				// The value is the remainder of the line and may be empty
+				std::string value;
+				ss.get();
+				std::getline(ss, value);
+
+				if (key == "checkpoint") {
+					this->checkpoints[job] = value;
+				} else {
+					this->reports[job] = value;
+				}
+			}
+
+			if (!valid) {
+				throw std::runtime_error("Invalid entry in manifest file!");
+			}
+		}
+
+		if (this->num_jobs < 1) {
+			throw std::runtime_error("Invalid number of jobs in manifest file!");
+		}
+	}
+
+	int get_num_jobs() const {
+		return this->num_jobs;
+	}
+
+	long long get_global_seed() const {
+		return this->global_seed;
+	}
+
+	/// @brief Returns whether a job has been stopped with a checkpoint.
+	bool has_checkpoint(int job) const {
+		return this->checkpoints.count(job) > 0;
+	}
+
+	const std::string& get_checkpoint(int job) const {
+		return this->checkpoints.at(job);
+	}
+
+	/// @brief Returns whether a job has been completed.
+	bool has_report(int job) const {
+		return this->reports.count(job) > 0;
+	}
+
+	/// @brief Returns the report of a completed job including the trailing newline.
+	std::string get_report(int job) const {
+		const std::string &line = this->reports.at(job);
+		return line.empty() ? line : line + "\n";
+	}
+};
+
+#endif /* CHECKPOINT_MANIFEST_H_ */
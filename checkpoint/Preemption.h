@@ -0,0 +1,84 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: Preemption.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+#ifndef CHECKPOINT_PREEMPTION_H_
+#define CHECKPOINT_PREEMPTION_H_
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+#include <signal.h>
+
+/// @brief Handles the termination signal that preemptible compute nodes receive
+/// shortly before they are shut down.
+/// @details The signal handler only records the request. The evolutionary algorithm
+/// polls the request once the current generation has been selected, writes a
+/// checkpoint and stops the job by throwing a PreemptedException. The process then
+/// exits with EXIT_CODE (EX_TEMPFAIL), so the job can be resumed from the checkpoint.
+/// The request is polled by the job threads and the asynchronous workers, so it is kept
+/// in a lock-free atomic, which can be stored from the handler as well.
+class Preemption {
+private:
+	static_assert(std::atomic<bool>::is_always_lock_free,
+			"The preemption request must be lock-free to be set by the signal handler!");
+
+	static inline std::atomic<bool> requested { false };
+
+	static void handle(int signal) {
+		requested.store(true, std::memory_order_relaxed);
+	}
+
+public:
+	static constexpr int EXIT_CODE = 75;
+
+	/// @brief Installs the handler for SIGTERM.
+	/// @details Interrupted system calls are restarted, so pending reads and writes
+	/// of the evaluation are not affected by the signal.
+	static void install() {
+		struct sigaction action { };
+		action.sa_handler = Preemption::handle;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = SA_RESTART;
+
+		if (sigaction(SIGTERM, &action, nullptr) != 0) {
+			throw std::runtime_error("Could not install the signal handler!");
+		}
+	}
+
+	/// @brief Returns whether the termination has been requested.
+	/// @return true if a SIGTERM has been received
+	static bool is_requested() {
+		return requested.load(std::memory_order_relaxed);
+	}
+};
+
+/// @brief Thrown when a job has been stopped after writing a checkpoint
+/// due to a termination request. Carries the checkpoint file of the job or
+/// the manifest of the experiment, respectively.
+class PreemptedException: public std::runtime_error {
+private:
+	std::string checkpoint_file;
+
+public:
+	PreemptedException(const std::string &p_checkpoint_file) :
+			std::runtime_error(
+					"Job has been preempted, resume from "
+							+ p_checkpoint_file), checkpoint_file(
+					p_checkpoint_file) {
+	}
+
+	const std::string& get_checkpoint_file() const {
+		return this->checkpoint_file;
+	}
+};
+
+#endif /* CHECKPOINT_PREEMPTION_H_ */
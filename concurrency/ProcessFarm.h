@@ -0,0 +1,624 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: ProcessFarm.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef CONCURRENCY_PROCESSFARM_H_
+#define CONCURRENCY_PROCESSFARM_H_
+
+#include <memory>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <stdexcept>
+#include <cstdint>
+#include <cerrno>
+#include <new>
+
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <signal.h>
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include "SharedRing.h"
+#include "../parameters/Parameters.h"
+#include "../random/Random.h"
+#include "../representation/Individual.h"
+#include "../problems/BlackBoxProblem.h"
+
+/// @brief Farm of forked evaluation processes that communicate over shared memory.
+/// @details Each worker process owns a request ring and a result ring in an anonymous
+/// shared mapping that is created before the workers are forked. Genomes are written
+/// into the request ring by the main process and fitness values are returned through
+/// the result ring together with the active nodes that have been decoded by the
+/// worker, both without serialization. The workers inherit the problem,
+/// including its dataset, from the main process. Since the dataset is never written
+/// during evolution, its pages remain shared between all processes.
+/// The farm is created in the setup of a job, before the job starts any helper thread,
+/// and each worker is forked by a supervisor process that is forked from the main
+/// process at construction. The supervisor stays single-threaded and forks a
+/// replacement once its worker terminates unexpectedly, so the main process never
+/// forks while its evaluation, checkpoint or stream threads are running. The main
+/// process re-queues the genomes the terminated worker has not answered yet.
+/// The tracer and the perf and allocation counters are dropped in the workers.
+/// @tparam E Evaluation Type
+/// @tparam G Genotype Type
+/// @tparam F Fitness Type
+template<class E, class G, class F>
+class ProcessFarm {
+private:
+	static constexpr int RING_CAPACITY = 64;
+	static constexpr int MAX_ATTEMPTS = 3;
+
+	enum MessageType {
+		EVALUATE = 0, SHUTDOWN = 1
+	};
+
+	enum WorkerState {
+		RUNNING = 0, TERMINATED = 1, RESTART = 2, STOPPED = 3
+	};
+
+	/// @brief State of a worker that is shared with its supervisor.
+	struct Control {
+		std::atomic<int32_t> state;
+	};
+
+	/// @brief Header of a request slot, the genes follow directly.
+	struct Request {
+		int64_t task;
+		int32_t type;
+	};
+
+	/// @brief Header of a result slot, the active nodes follow directly.
+	struct Result {
+		int64_t task;
+		F fitness;
+		int32_t num_active_nodes;
+	};
+
+	std::shared_ptr<Parameters> parameters;
+	std::shared_ptr<Random> random;
+	std::shared_ptr<BlackBoxProblem<E, G, F>> problem;
+
+	int num_workers;
+	int genome_size;
+	int num_nodes;
+	pid_t parent;
+
+	void *memory;
+	std::size_t memory_size;
+
+	std::vector<std::shared_ptr<SharedRing>> requests;
+	std::vector<std::shared_ptr<SharedRing>> results;
+	std::vector<Control*> controls;
+	std::vector<pid_t> supervisors;
+
+	void spawn(int worker);
+	int supervise(int worker);
+	void work(int worker, pid_t supervisor);
+	bool has_terminated(int worker);
+	void restart(int worker);
+	bool collect(int worker,
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+			std::deque<int> &in_flight,
+			const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated);
+	static void backoff(int &round);
+
+public:
+	ProcessFarm(std::shared_ptr<Parameters> p_parameters,
+			std::shared_ptr<Random> p_random,
+			std::shared_ptr<BlackBoxProblem<E, G, F>> p_problem,
+			int p_num_workers);
+	virtual ~ProcessFarm();
+
+	void evaluate(std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+			const std::atomic<bool> *cancel,
+			const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated);
+	int size() const;
+};
+
+/// @brief Constructor that creates the shared rings and forks the supervisors.
+/// @details Must be called before the calling process starts further threads, since
+/// the supervisors and therefore the workers are copies of the calling thread.
+/// @param p_parameters shared pointer to parameter object
+/// @param p_random shared pointer to random generator instance
+/// @param p_problem problem that is evaluated by the workers
+/// @param p_num_workers number of worker processes
+template<class E, class G, class F>
+ProcessFarm<E, G, F>::ProcessFarm(std::shared_ptr<Parameters> p_parameters,
+		std::shared_ptr<Random> p_random,
+		std::shared_ptr<BlackBoxProblem<E, G, F>> p_problem,
+		int p_num_workers) {
+
+	if (p_parameters != nullptr && p_random != nullptr
+			&& p_problem != nullptr) {
+		parameters = p_parameters;
+		random = p_random;
+		problem = p_problem;
+	} else {
+		throw std::invalid_argument(
+				"Nullpointer exception in process farm class!");
+	}
+
+	if (p_num_workers <= 0) {
+		throw std::invalid_argument(
+				"Number of workers must be greater zero in process farm class!");
+	}
+
+	num_workers = p_num_workers;
+	genome_size = parameters->get_genome_size();
+	num_nodes = parameters->get_num_function_nodes();
+	parent = getpid();
+
+	std::size_t request_size = sizeof(Request) + genome_size * sizeof(G);
+	std::size_t result_size = sizeof(Result) + num_nodes * sizeof(int);
+	std::size_t request_bytes = SharedRing::bytes(RING_CAPACITY, request_size);
+	std::size_t result_bytes = SharedRing::bytes(RING_CAPACITY, result_size);
+
+	std::size_t control_bytes = SharedRing::align(num_workers * sizeof(Control));
+
+	memory_size = control_bytes + num_workers * (request_bytes + result_bytes);
+	memory = mmap(nullptr, memory_size, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+	if (memory == MAP_FAILED) {
+		throw std::runtime_error("Could not map the shared memory of the process farm!");
+	}
+
+	char *base = static_cast<char*>(memory);
+
+	static_assert(std::atomic<int32_t>::is_always_lock_free,
+			"The worker state must be lock-free to be shared between processes!");
+
+	for (int i = 0; i < num_workers; i++) {
+		controls.push_back(new (base + i * sizeof(Control)) Control { RUNNING });
+	}
+
+	base += control_bytes;
+
+	for (int i = 0; i < num_workers; i++) {
+		requests.push_back(
+				std::make_shared<SharedRing>(base, RING_CAPACITY, request_size));
+		base += request_bytes;
+		results.push_back(
+				std::make_shared<SharedRing>(base, RING_CAPACITY, result_size));
+		base += result_bytes;
+	}
+
+	supervisors.resize(num_workers, -1);
+
+	for (int i = 0; i < num_workers; i++) {
+		this->spawn(i);
+	}
+}
+
+/// @brief Destructor that shuts the workers down and releases the shared memory.
+/// @details The supervisors are stopped, so that they do not replace their workers 
+/// anymore. Workers that can not be reached through their request ring are killed 
+/// together with their supervisor.
+template<class E, class G, class F>
+ProcessFarm<E, G, F>::~ProcessFarm() {
+
+	for (int i = 0; i < num_workers; i++) {
+		if (supervisors[i] <= 0) {
+			continue;
+		}
+
+		controls[i]->state.store(STOPPED, std::memory_order_release);
+
+		void *slot = requests[i]->reserve();
+
+		if (slot != nullptr) {
+			static_cast<Request*>(slot)->type = SHUTDOWN;
+			requests[i]->publish();
+		} else {
+			kill(supervisors[i], SIGKILL);
+		}
+	}
+
+	for (int i = 0; i < num_workers; i++) {
+		if (supervisors[i] > 0) {
+			waitpid(supervisors[i], nullptr, 0);
+		}
+	}
+
+	munmap(memory, memory_size);
+}
+
+/// @brief Forks the supervisor of a worker.
+/// @details The supervisor leaves with _exit, so that buffers and destructors
+/// inherited from the main process are not processed twice.
+/// @param worker index of the worker
+template<class E, class G, class F>
+void ProcessFarm<E, G, F>::spawn(int worker) {
+
+	pid_t pid = fork();
+
+	if (pid < 0) {
+		throw std::runtime_error("Could not fork an evaluation process!");
+	}
+
+	if (pid == 0) {
+		_exit(this->supervise(worker));
+	}
+
+	supervisors[worker] = pid;
+}
+
+/// @brief Loop of a supervisor process.
+/// @details Forks the worker and waits for its termination. A worker that has 
+/// terminated unexpectedly is reported to the main process through the shared state,
+/// and is replaced once the main process has taken over its results and has 
+/// reset its rings. The supervisor terminates together with its worker on a 
+/// shutdown request or when the main process is gone.
+/// @param worker index of the worker
+/// @return exit status of the supervisor
+template<class E, class G, class F>
+int ProcessFarm<E, G, F>::supervise(int worker) {
+
+#ifdef __linux__
+	prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+
+	if (getppid() != this->parent) {
+		return 0;
+	}
+
+	// The workers evaluate with a copy of the problem, the hooks of the
+	// main process would only record into the copies
+	std::shared_ptr<Evaluator<E, G, F>> evaluator = this->problem->get_evaluator();
+	evaluator->set_tracer(nullptr);
+	evaluator->set_perf_counters(nullptr);
+	evaluator->set_alloc_counters(nullptr);
+
+	std::atomic<int32_t> &state = this->controls[worker]->state;
+	pid_t supervisor = getpid();
+
+	while (true) {
+		pid_t pid = fork();
+
+		if (pid < 0) {
+			return 1;
+		}
+
+		if (pid == 0) {
+			int status = 0;
+			try {
+				this->work(worker, supervisor);
+			} catch (...) {
+				status = 1;
+			}
+			_exit(status);
+		}
+
+		int status;
+		while (waitpid(pid, &status, 0) < 0) {
+			if (errno != EINTR) {
+				return 1;
+			}
+		}
+
+		if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+			return 0;
+		}
+
+		int32_t expected = RUNNING;
+		if (!state.compare_exchange_strong(expected, TERMINATED,
+				std::memory_order_acq_rel)) {
+			return 0;
+		}
+
+		int round = 0;
+		expected = RESTART;
+
+		while (!state.compare_exchange_weak(expected, RUNNING,
+				std::memory_order_acq_rel)) {
+			if (expected == STOPPED || getppid() != this->parent) {
+				return 0;
+			}
+			expected = RESTART;
+			backoff(round);
+		}
+	}
+}
+
+/// @brief Loop of a worker process.
+/// @details Evaluates the genomes of the request ring in order and answers each
+/// with its fitness. The worker terminates on a shutdown request or when the main
+/// process is gone.
+/// @param worker index of the worker
+/// @param supervisor process id of the supervisor
+template<class E, class G, class F>
+void ProcessFarm<E, G, F>::work(int worker, pid_t supervisor) {
+
+#ifdef __linux__
+	prctl(PR_SET_PDEATHSIG, SIGKILL);
+#endif
+
+	if (getppid() != supervisor) {
+		return;
+	}
+
+	std::shared_ptr<Individual<G, F>> individual = std::make_shared<
+			Individual<G, F>>(this->random, this->parameters);
+
+	SharedRing &request_ring = *this->requests[worker];
+	SharedRing &result_ring = *this->results[worker];
+
+	int round = 0;
+
+	while (true) {
+		const void *slot = request_ring.front();
+
+		if (slot == nullptr) {
+			if (getppid() != supervisor) {
+				return;
+			}
+			backoff(round);
+			continue;
+		}
+
+		round = 0;
+
+		const Request *request = static_cast<const Request*>(slot);
+
+		if (request->type == SHUTDOWN) {
+			return;
+		}
+
+		const G *genes = reinterpret_cast<const G*>(static_cast<const char*>(slot)
+				+ sizeof(Request));
+
+		std::copy(genes, genes + this->genome_size,
+				individual->get_genome().get());
+		individual->set_decoded(false);
+		individual->set_evaluated(false);
+
+		this->problem->evaluate_individual(individual);
+
+		void *out;
+		while ((out = result_ring.reserve()) == nullptr) {
+			backoff(round);
+		}
+
+		Result *result = static_cast<Result*>(out);
+		result->task = request->task;
+		result->fitness = individual->get_fitness();
+
+		const std::vector<int> &active_nodes = *individual->get_active_nodes();
+		result->num_active_nodes = std::min((int) active_nodes.size(),
+				this->num_nodes);
+		std::copy(active_nodes.begin(),
+				active_nodes.begin() + result->num_active_nodes,
+				reinterpret_cast<int*>(static_cast<char*>(out) + sizeof(Result)));
+
+		result_ring.publish();
+		request_ring.pop();
+	}
+}
+
+/// @brief Checks whether a worker has terminated.
+/// @details A terminated supervisor can not replace its worker anymore, which
+/// leads to an exception.
+/// @param worker index of the worker
+/// @return true if the worker process has terminated and waits for its replacement
+template<class E, class G, class F>
+bool ProcessFarm<E, G, F>::has_terminated(int worker) {
+	int status;
+
+	if (waitpid(this->supervisors[worker], &status, WNOHANG)
+			== this->supervisors[worker]) {
+		this->supervisors[worker] = -1;
+		throw std::runtime_error("Supervisor of an evaluation process terminated!");
+	}
+
+	return this->controls[worker]->state.load(std::memory_order_acquire)
+			== TERMINATED;
+}
+
+/// @brief Lets the supervisor replace a terminated worker with empty rings.
+/// @param worker index of the worker
+template<class E, class G, class F>
+void ProcessFarm<E, G, F>::restart(int worker) {
+	this->requests[worker]->reset();
+	this->results[worker]->reset();
+	this->controls[worker]->state.store(RESTART, std::memory_order_release);
+}
+
+/// @brief Takes over the results a worker has published so far.
+/// @param worker index of the worker
+/// @param individuals individuals of the current call
+/// @param in_flight tasks sent to the worker that have not been answered
+/// @param on_evaluated function that is called for each evaluated individual
+/// @return true if at least one result has been collected
+template<class E, class G, class F>
+bool ProcessFarm<E, G, F>::collect(int worker,
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		std::deque<int> &in_flight,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+
+	bool collected = false;
+	const void *slot;
+
+	while ((slot = this->results[worker]->front()) != nullptr) {
+		const Result *result = static_cast<const Result*>(slot);
+		std::shared_ptr<Individual<G, F>> individual = individuals.at(
+				result->task);
+
+		const int *active_nodes = reinterpret_cast<const int*>(static_cast<const char*>(slot)
+				+ sizeof(Result));
+		individual->get_active_nodes()->assign(active_nodes,
+				active_nodes + result->num_active_nodes);
+		individual->set_decoded(true);
+		individual->set_fitness(result->fitness);
+		individual->set_evaluated(true);
+
+		this->results[worker]->pop();
+
+		// The worker answers the requests in order
+		in_flight.pop_front();
+		collected = true;
+
+		on_evaluated(individual);
+	}
+
+	return collected;
+}
+
+/// @brief Waits with increasing pause while there is nothing to do.
+/// @param round number of previous rounds without progress
+template<class E, class G, class F>
+void ProcessFarm<E, G, F>::backoff(int &round) {
+	if (round < 16) {
+		std::this_thread::yield();
+	} else {
+		int pause = 1 << std::min(round - 16, 8);
+		std::this_thread::sleep_for(std::chrono::microseconds(pause));
+	}
+	round++;
+}
+
+/// @brief Evaluates the individuals with the worker processes.
+/// @details Individuals are dispatched round-robin to workers with free slots and
+/// the results are collected as soon as they arrive. Once the cancellation flag is
+/// set, no further individuals are dispatched and those are left unevaluated.
+/// The genomes of a worker that has terminated are re-queued and evaluated by the
+/// replacement its supervisor forks. An individual that has caused the termination of
+/// MAX_ATTEMPTS workers leads to an exception.
+/// @param individuals individuals to evaluate
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void ProcessFarm<E, G, F>::evaluate(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+
+	std::deque<int> pending;
+	std::vector<int> attempts(individuals.size(), 0);
+	std::vector<std::deque<int>> in_flight(this->num_workers);
+
+	for (int i = 0; i < (int) individuals.size(); i++) {
+		if (!individuals.at(i)->is_evaluated()) {
+			pending.push_back(i);
+		}
+	}
+
+	int outstanding = 0;
+	int next_worker = 0;
+	int round = 0;
+
+	while (!pending.empty() || outstanding > 0) {
+		bool progress = false;
+
+		if (cancel != nullptr && *cancel) {
+			pending.clear();
+		}
+
+		while (!pending.empty()) {
+			int worker = -1;
+
+			for (int i = 0; i < this->num_workers; i++) {
+				int candidate = (next_worker + i) % this->num_workers;
+				if ((int) in_flight[candidate].size() < RING_CAPACITY) {
+					worker = candidate;
+					break;
+				}
+			}
+
+			if (worker < 0) {
+				break;
+			}
+
+			next_worker = (worker + 1) % this->num_workers;
+
+			int task = pending.front();
+			pending.pop_front();
+
+			void *slot = this->requests[worker]->reserve();
+			Request *request = static_cast<Request*>(slot);
+			request->task = task;
+			request->type = EVALUATE;
+
+			std::shared_ptr<G[]> genome = individuals.at(task)->get_genome();
+			std::copy(genome.get(), genome.get() + this->genome_size,
+					reinterpret_cast<G*>(static_cast<char*>(slot)
+							+ sizeof(Request)));
+
+			this->requests[worker]->publish();
+
+			in_flight[worker].push_back(task);
+			outstanding++;
+			progress = true;
+		}
+
+		for (int i = 0; i < this->num_workers; i++) {
+			int before = in_flight[i].size();
+			if (this->collect(i, individuals, in_flight[i], on_evaluated)) {
+				outstanding -= before - in_flight[i].size();
+				progress = true;
+			}
+		}
+
+		if (progress) {
+			round = 0;
+			continue;
+		}
+
+		for (int i = 0; i < this->num_workers; i++) {
+			if (!this->has_terminated(i)) {
+				continue;
+			}
+
+			// Take over the results that have been published before the termination
+			int before = in_flight[i].size();
+			this->collect(i, individuals, in_flight[i], on_evaluated);
+			outstanding -= before - in_flight[i].size();
+
+			while (!in_flight[i].empty()) {
+				int task = in_flight[i].back();
+				in_flight[i].pop_back();
+				outstanding--;
+
+				if (++attempts[task] >= MAX_ATTEMPTS) {
+					throw std::runtime_error(
+							"Individual terminated several evaluation processes!");
+				}
+
+				pending.push_front(task);
+			}
+
+			this->restart(i);
+			progress = true;
+		}
+
+		if (!progress) {
+			backoff(round);
+		}
+	}
+}
+
+/// @brief Returns the number of worker processes.
+/// @return number of workers
+template<class E, class G, class F>
+int ProcessFarm<E, G, F>::size() const {
+	return this->num_workers;
+}
+
+#endif /* CONCURRENCY_PROCESSFARM_H_ */
@@ -0,0 +1,148 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: SharedRing.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef CONCURRENCY_SHAREDRING_H_
+#define CONCURRENCY_SHAREDRING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+
+/// @brief Lock-free single-producer/single-consumer ring of fixed-size slots.
+/// @details The ring operates on memory that is provided by the caller, e.g. a
+/// shared mapping that is inherited by forked processes. The producer reserves
+/// a slot, fills it in place and publishes it; the consumer reads the front slot
+/// in place and pops it. Head and tail are kept on separate cache lines and are
+/// only written by the consumer and the producer respectively.
+class SharedRing {
+private:
+	struct Header {
+		alignas(64) std::atomic<uint64_t> head;
+		alignas(64) std::atomic<uint64_t> tail;
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free,
+			"Shared ring requires lock-free 64-bit atomics!");
+
+	Header *header;
+	char *slots;
+	int capacity;
+	std::size_t slot_size;
+
+public:
+	SharedRing(void *p_memory, int p_capacity, std::size_t p_slot_size);
+	virtual ~SharedRing() = default;
+
+	static std::size_t bytes(int p_capacity, std::size_t p_slot_size);
+	static std::size_t align(std::size_t size);
+
+	void reset();
+	void* reserve();
+	void publish();
+	const void* front() const;
+	void pop();
+	int size() const;
+};
+
+/// @brief Constructor that places the ring into the passed memory.
+/// @param p_memory memory of at least bytes(p_capacity, p_slot_size) bytes,
+/// aligned to a cache line
+/// @param p_capacity number of slots
+/// @param p_slot_size size of a slot in bytes
+inline SharedRing::SharedRing(void *p_memory, int p_capacity,
+		std::size_t p_slot_size) {
+
+	if (p_memory == nullptr) {
+		throw std::invalid_argument("Nullpointer exception in ring class!");
+	}
+
+	if (p_capacity <= 0 || p_slot_size == 0) {
+		throw std::invalid_argument("Invalid ring dimension!");
+	}
+
+	capacity = p_capacity;
+	slot_size = align(p_slot_size);
+	header = new (p_memory) Header();
+	slots = static_cast<char*>(p_memory) + align(sizeof(Header));
+
+	this->reset();
+}
+
+/// @brief Returns the number of bytes required by a ring.
+/// @param p_capacity number of slots
+/// @param p_slot_size size of a slot in bytes
+/// @return number of bytes
+inline std::size_t SharedRing::bytes(int p_capacity, std::size_t p_slot_size) {
+	return align(sizeof(Header)) + p_capacity * align(p_slot_size);
+}
+
+/// @brief Rounds a size up to a multiple of the cache line size.
+/// @param size size in bytes
+/// @return aligned size in bytes
+inline std::size_t SharedRing::align(std::size_t size) {
+	return (size + 63) / 64 * 64;
+}
+
+/// @brief Empties the ring. Must not be called while one of the sides is active.
+inline void SharedRing::reset() {
+	header->head.store(0, std::memory_order_relaxed);
+	header->tail.store(0, std::memory_order_release);
+}
+
+/// @brief Reserves the next slot for the producer.
+/// @return pointer to the slot or nullptr if the ring is full
+inline void* SharedRing::reserve() {
+	uint64_t tail = header->tail.load(std::memory_order_relaxed);
+	uint64_t head = header->head.load(std::memory_order_acquire);
+
+	if (tail - head >= (uint64_t) capacity) {
+		return nullptr;
+	}
+
+	return slots + (tail % capacity) * slot_size;
+}
+
+/// @brief Makes the reserved slot visible to the consumer.
+inline void SharedRing::publish() {
+	uint64_t tail = header->tail.load(std::memory_order_relaxed);
+	header->tail.store(tail + 1, std::memory_order_release);
+}
+
+/// @brief Returns the front slot for the consumer.
+/// @return pointer to the slot or nullptr if the ring is empty
+inline const void* SharedRing::front() const {
+	uint64_t head = header->head.load(std::memory_order_relaxed);
+	uint64_t tail = header->tail.load(std::memory_order_acquire);
+
+	if (head == tail) {
+		return nullptr;
+	}
+
+	return slots + (head % capacity) * slot_size;
+}
+
+/// @brief Releases the front slot to the producer.
+inline void SharedRing::pop() {
+	uint64_t head = header->head.load(std::memory_order_relaxed);
+	header->head.store(head + 1, std::memory_order_release);
+}
+
+/// @brief Returns the number of occupied slots.
+/// @return number of slots
+inline int SharedRing::size() const {
+	return header->tail.load(std::memory_order_acquire)
+			- header->head.load(std::memory_order_acquire);
+}
+
+#endif /* CONCURRENCY_SHAREDRING_H_ */
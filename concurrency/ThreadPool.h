@@ -0,0 +1,260 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: ThreadPool.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef CONCURRENCY_THREADPOOL_H_
+#define CONCURRENCY_THREADPOOL_H_
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <vector>
+#include <exception>
+#include <stdexcept>
+#include <chrono>
+
+/// @brief Fixed-size pool of worker threads that execute indexed tasks.
+/// @details The threads are created once and wait between the rounds. A round
+/// consists of a number of tasks that are claimed dynamically by the workers. The
+/// calling thread takes part in each round as worker 0, so a pool of size n
+/// creates n-1 threads. Each task learns the index of the worker that executes
+/// it, which allows the caller to provide per-worker state such as evaluators.
+/// The time each worker spends executing tasks is accumulated to assess the load balance.
+class ThreadPool {
+private:
+	int num_workers;
+
+	std::vector<std::thread> threads;
+	std::mutex mtx;
+	std::condition_variable cv_start;
+	std::condition_variable cv_done;
+
+	std::function<void(int, int)> task;
+	int num_tasks;
+	std::atomic<int> next_task;
+	int busy_workers;
+	long long round;
+	bool shutdown;
+	bool broadcast;
+
+	std::exception_ptr error;
+
+	std::vector<long long> busy_nanoseconds;
+
+	void work(int worker);
+	void execute(int worker);
+
+public:
+	ThreadPool(int p_num_workers);
+	virtual ~ThreadPool();
+
+	void run(int p_num_tasks, const std::function<void(int, int)> &p_task);
+	void run_on_workers(const std::function<void(int)> &p_task);
+	int size() const;
+
+	std::vector<double> get_busy_seconds() const;
+	void reset_busy_seconds();
+};
+
+/// @brief Constructor that starts the worker threads.
+/// @param p_num_workers number of workers including the calling thread
+inline ThreadPool::ThreadPool(int p_num_workers) {
+
+	if (p_num_workers <= 0) {
+		throw std::invalid_argument(
+				"Number of workers must be greater zero in thread pool class!");
+	}
+
+	num_workers = p_num_workers;
+	num_tasks = 0;
+	next_task = 0;
+	busy_workers = 0;
+	round = 0;
+	shutdown = false;
+	broadcast = false;
+	error = nullptr;
+
+	busy_nanoseconds.assign(num_workers, 0);
+
+	for (int i = 1; i < num_workers; i++) {
+		threads.push_back(std::thread(&ThreadPool::work, this, i));
+	}
+}
+
+/// @brief Destructor that stops and joins the worker threads.
+inline ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		shutdown = true;
+	}
+	cv_start.notify_all();
+
+	for (auto &t : threads) {
+		t.join();
+	}
+}
+
+/// @brief Claims and executes tasks of the current round until none is left.
+/// @param worker index of the executing worker
+inline void ThreadPool::execute(int worker) {
+	// Each worker executes the task exactly once with its own index
+	if (broadcast) {
+		try {
+			task(worker, worker);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mtx);
+			if (error == nullptr) {
+				error = std::current_exception();
+			}
+		}
+		return;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+
+	int index;
+	while ((index = next_task++) < num_tasks) {
+		try {
+			task(index, worker);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(mtx);
+			if (error == nullptr) {
+				error = std::current_exception();
+			}
+		}
+	}
+
+	// Each worker only writes its own slot, the round is synchronized by the mutex
+	busy_nanoseconds[worker] += std::chrono::duration_cast<
+			std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// @brief Loop of a worker thread that waits for the next round.
+/// @param worker index of the worker
+inline void ThreadPool::work(int worker) {
+	long long last_round = 0;
+
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mtx);
+			cv_start.wait(lock, [&]() {
+				return shutdown || round != last_round;
+			});
+
+			if (shutdown) {
+				return;
+			}
+
+			last_round = round;
+		}
+
+		execute(worker);
+
+		{
+			std::lock_guard<std::mutex> lock(mtx);
+			busy_workers--;
+		}
+		cv_done.notify_one();
+	}
+}
+
+/// @brief Executes the tasks 0 to p_num_tasks - 1 and blocks until all are finished.
+/// @details Rethrows the first exception that has been thrown by a task.
+/// @param p_num_tasks number of tasks
+/// @param p_task function that is called with the task and the worker index
+inline void ThreadPool::run(int p_num_tasks,
+		const std::function<void(int, int)> &p_task) {
+
+	if (p_num_tasks <= 0) {
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		task = p_task;
+		num_tasks = p_num_tasks;
+		broadcast = false;
+		next_task = 0;
+		busy_workers = num_workers - 1;
+		error = nullptr;
+		round++;
+	}
+	cv_start.notify_all();
+
+	execute(0);
+
+	std::unique_lock<std::mutex> lock(mtx);
+	cv_done.wait(lock, [&]() {
+		return busy_workers == 0;
+	});
+
+	if (error != nullptr) {
+		std::rethrow_exception(error);
+	}
+}
+
+/// @brief Executes a task once on each worker and blocks until all are finished.
+/// @details Used to initialize per-worker state on the thread of the worker, 
+/// e.g. CPU affinity or memory that should be first touched by the worker.
+/// @param p_task function that is called with the worker index
+inline void ThreadPool::run_on_workers(const std::function<void(int)> &p_task) {
+	{
+		std::lock_guard<std::mutex> lock(mtx);
+		task = [p_task](int index, int worker) {
+			p_task(worker);
+		};
+		num_tasks = num_workers;
+		broadcast = true;
+		busy_workers = num_workers - 1;
+		error = nullptr;
+		round++;
+	}
+	cv_start.notify_all();
+
+	execute(0);
+
+	std::unique_lock<std::mutex> lock(mtx);
+	cv_done.wait(lock, [&]() {
+		return busy_workers == 0;
+	});
+
+	if (error != nullptr) {
+		std::rethrow_exception(error);
+	}
+}
+
+/// @brief Returns the number of workers including the calling thread.
+/// @return number of workers
+inline int ThreadPool::size() const {
+	return num_workers;
+}
+
+/// @brief Returns the time each worker has spent executing tasks since the last reset.
+/// @details Must not be called while a round is running.
+/// @return busy time of each worker in seconds
+inline std::vector<double> ThreadPool::get_busy_seconds() const {
+	std::vector<double> seconds;
+
+	for (long long n : busy_nanoseconds) {
+		seconds.push_back(n * 1e-9);
+	}
+
+	return seconds;
+}
+
+/// @brief Resets the busy times of the workers.
+inline void ThreadPool::reset_busy_seconds() {
+	busy_nanoseconds.assign(num_workers, 0);
+}
+
+#endif /* CONCURRENCY_THREADPOOL_H_ */
@@ -0,0 +1,247 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: Topology.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef CONCURRENCY_TOPOLOGY_H_
+#define CONCURRENCY_TOPOLOGY_H_
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+/// @brief Describes the NUMA topology of the CPUs the process may run on.
+/// @details Reads the NUMA nodes and their CPU lists from sysfs and restricts them
+/// to the CPUs of the affinity mask of the process. Falls back to a single node
+/// with all allowed CPUs if the topology is not available, e.g. on other
+/// operating systems or in containers without sysfs.
+class Topology {
+private:
+	std::vector<std::vector<int>> node_cpus;
+
+	static std::vector<int> parse_cpu_list(const std::string &list);
+	static std::vector<int> allowed_cpus();
+
+public:
+	Topology();
+	virtual ~Topology() = default;
+
+	int num_nodes() const;
+	int num_cpus() const;
+	std::vector<int> assign_cpus(int num_workers) const;
+	int node_of_cpu(int cpu) const;
+
+	static bool pin_current_thread(int cpu);
+	static std::vector<int> current_thread_cpus();
+	static bool pin_current_thread(const std::vector<int> &cpus);
+};
+
+/// @brief Constructor that detects the topology.
+inline Topology::Topology() {
+
+	std::vector<int> allowed = allowed_cpus();
+	std::string node_dir = "/sys/devices/system/node/";
+
+	std::error_code ec;
+	if (std::filesystem::is_directory(node_dir, ec)) {
+		for (int node = 0;; node++) {
+			std::stringstream ss;
+			ss << node_dir << "node" << node << "/cpulist";
+			std::ifstream ifs(ss.str());
+
+			if (!ifs.is_open()) {
+				break;
+			}
+
+			std::string list;
+			std::getline(ifs, list);
+
+			std::vector<int> cpus;
+			for (int cpu : parse_cpu_list(list)) {
+				if (std::find(allowed.begin(), allowed.end(), cpu)
+						!= allowed.end()) {
+					cpus.push_back(cpu);
+				}
+			}
+
+			if (!cpus.empty()) {
+				node_cpus.push_back(cpus);
+			}
+		}
+	}
+
+	if (node_cpus.empty()) {
+		node_cpus.push_back(allowed);
+	}
+}
+
+/// @brief Parses a CPU list like "0-3,8,10-11".
+/// @param list CPU list in sysfs notation
+/// @return CPU numbers
+inline std::vector<int> Topology::parse_cpu_list(const std::string &list) {
+	std::vector<int> cpus;
+	std::stringstream ss(list);
+	std::string range;
+
+	while (std::getline(ss, range, ',')) {
+		if (range.empty()) {
+			continue;
+		}
+
+		try {
+			std::size_t dash = range.find('-');
+			if (dash == std::string::npos) {
+				cpus.push_back(std::stoi(range));
+			} else {
+				int first = std::stoi(range.substr(0, dash));
+				int last = std::stoi(range.substr(dash + 1));
+				for (int cpu = first; cpu <= last; cpu++) {
+					cpus.push_back(cpu);
+				}
+			}
+		} catch (const std::exception &e) {
+			// Ignore malformed entries
+		}
+	}
+
+	return cpus;
+}
+
+/// @brief Returns the CPUs of the affinity mask of the process.
+/// @return CPU numbers
+inline std::vector<int> Topology::allowed_cpus() {
+	std::vector<int> cpus;
+
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &set)) {
+				cpus.push_back(cpu);
+			}
+		}
+	}
+#endif
+
+	if (cpus.empty()) {
+		cpus.push_back(0);
+	}
+
+	return cpus;
+}
+
+inline int Topology::num_nodes() const {
+	return this->node_cpus.size();
+}
+
+inline int Topology::num_cpus() const {
+	int n = 0;
+	for (auto &cpus : this->node_cpus) {
+		n += cpus.size();
+	}
+	return n;
+}
+
+/// @brief Assigns a CPU to each worker.
+/// @details The workers are spread round-robin over the nodes and take the next
+/// free CPU of the node. CPUs are reused if there are more workers than CPUs.
+/// @param num_workers number of workers
+/// @return CPU of each worker
+inline std::vector<int> Topology::assign_cpus(int num_workers) const {
+	std::vector<int> assignment;
+	std::vector<int> next(this->node_cpus.size(), 0);
+
+	for (int i = 0; i < num_workers; i++) {
+		int node = i % this->node_cpus.size();
+		const std::vector<int> &cpus = this->node_cpus.at(node);
+		assignment.push_back(cpus.at(next[node] % cpus.size()));
+		next[node]++;
+	}
+
+	return assignment;
+}
+
+/// @brief Returns the node of a CPU.
+/// @param cpu CPU number
+/// @return node index or 0 if the CPU is unknown
+inline int Topology::node_of_cpu(int cpu) const {
+	for (int node = 0; node < (int) this->node_cpus.size(); node++) {
+		const std::vector<int> &cpus = this->node_cpus.at(node);
+		if (std::find(cpus.begin(), cpus.end(), cpu) != cpus.end()) {
+			return node;
+		}
+	}
+	return 0;
+}
+
+/// @brief Binds the calling thread to a CPU.
+/// @param cpu CPU number
+/// @return true if the thread has been bound
+inline bool Topology::pin_current_thread(int cpu) {
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+
+/// @brief Returns the CPUs the calling thread may run on, e.g. to restore them after pinning.
+/// @return CPU numbers of the affinity mask of the thread, empty if not available
+inline std::vector<int> Topology::current_thread_cpus() {
+	std::vector<int> cpus;
+
+#ifdef __linux__
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &set)) {
+				cpus.push_back(cpu);
+			}
+		}
+	}
+#endif
+
+	return cpus;
+}
+
+/// @brief Binds the calling thread to a set of CPUs.
+/// @param cpus CPU numbers, nothing is done if empty
+/// @return true if the thread has been bound
+inline bool Topology::pin_current_thread(const std::vector<int> &cpus) {
+#ifdef __linux__
+	if (cpus.empty()) {
+		return false;
+	}
+
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu : cpus) {
+		CPU_SET(cpu, &set);
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+
+#endif /* CONCURRENCY_TOPOLOGY_H_ */
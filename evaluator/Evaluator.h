@@ -16,6 +16,11 @@
 #include "../parameters/Parameters.h"
 #include "../functions/Functions.h"
 #include "../representation/Species.h"
+#include "../profiling/PhaseTimer.h"
+#include "../profiling/EvalCounters.h"
+#include "../profiling/PerfCounters.h"
+#include "../profiling/AllocCounters.h"
+#include "../profiling/Tracer.h"
 
 #include <map>
 #include <sstream>
@@ -52,6 +57,15 @@ private:
 
 	bool evaluate_expression = true;
 
+	std::shared_ptr<PhaseTimer> timer;
+	std::shared_ptr<PerfCounters> perf_counters;
+	std::shared_ptr<AllocCounters> alloc_counters;
+	std::shared_ptr<Tracer> tracer;
+
+#ifdef CGP_EVAL_COUNTERS
+	std::shared_ptr<EvalCounters> counters;
+#endif
+
 	int gene_at(std::shared_ptr<G[]> genome, int position);
 
 public:
@@ -88,6 +102,18 @@ public:
 	void determine_active_nodes(std::shared_ptr<Individual<G, F>> individual);
 
 	void clear_maps();
+
+	void set_phase_timer(std::shared_ptr<PhaseTimer> p_timer);
+	void set_perf_counters(std::shared_ptr<PerfCounters> p_perf_counters);
+	PerfCounters* get_perf_counters() const;
+	void set_alloc_counters(std::shared_ptr<AllocCounters> p_alloc_counters);
+	AllocCounters* get_alloc_counters() const;
+	void set_tracer(std::shared_ptr<Tracer> p_tracer);
+	Tracer* get_tracer() const;
+
+#ifdef CGP_EVAL_COUNTERS
+	const std::shared_ptr<EvalCounters>& get_counters() const;
+#endif
 };
 
 template<class E, class G, class F>
@@ -110,6 +136,11 @@ Evaluator<E, G, F>::Evaluator(std::shared_ptr<Parameters> p_parameters,
 	max_arity = parameters->get_max_arity();
 
 	evaluate_expression = parameters->is_evaluate_expression();
+
+	// Copies of the evaluator, e.g. of problem clones, share the counters
+#ifdef CGP_EVAL_COUNTERS
+	counters = std::make_shared<EvalCounters>();
+#endif
 }
 
 /// @brief Returns the gene at the specified position in the genome.
@@ -131,6 +162,70 @@ int Evaluator<E, G, F>::gene_at(std::shared_ptr<G[]> genome, int position) {
 	}
 }
 
+/// @brief Sets the timer the decoding time is added to.
+/// @details Copies of the evaluator share the timer.
+/// @param p_timer shared pointer to the timer or nullptr to disable timing
+template<class E, class G, class F>
+void Evaluator<E, G, F>::set_phase_timer(std::shared_ptr<PhaseTimer> p_timer) {
+	this->timer = p_timer;
+}
+
+/// @brief Sets the hardware performance counters the decoding and evaluation are sampled with.
+/// @details Copies of the evaluator share the counters.
+/// @param p_perf_counters shared pointer to the counters or nullptr to disable sampling
+template<class E, class G, class F>
+void Evaluator<E, G, F>::set_perf_counters(
+		std::shared_ptr<PerfCounters> p_perf_counters) {
+	this->perf_counters = p_perf_counters;
+}
+
+/// @brief Returns the hardware performance counters of the evaluator.
+/// @return pointer to the counters or nullptr if sampling is disabled
+template<class E, class G, class F>
+PerfCounters* Evaluator<E, G, F>::get_perf_counters() const {
+	return this->perf_counters.get();
+}
+
+/// @brief Sets the counters the allocations of the decoding and evaluation are added to.
+/// @details Copies of the evaluator share the counters.
+/// @param p_alloc_counters shared pointer to the counters or nullptr to disable counting
+template<class E, class G, class F>
+void Evaluator<E, G, F>::set_alloc_counters(
+		std::shared_ptr<AllocCounters> p_alloc_counters) {
+	this->alloc_counters = p_alloc_counters;
+}
+
+/// @brief Returns the allocation counters of the evaluator.
+/// @return pointer to the counters or nullptr if counting is disabled
+template<class E, class G, class F>
+AllocCounters* Evaluator<E, G, F>::get_alloc_counters() const {
+	return this->alloc_counters.get();
+}
+
+/// @brief Sets the tracer the evaluation of fitness case shards is recorded with.
+/// @details Copies of the evaluator share the tracer.
+/// @param p_tracer shared pointer to the tracer or nullptr to disable tracing
+template<class E, class G, class F>
+void Evaluator<E, G, F>::set_tracer(std::shared_ptr<Tracer> p_tracer) {
+	this->tracer = p_tracer;
+}
+
+/// @brief Returns the tracer of the evaluator.
+/// @return pointer to the tracer or nullptr if tracing is disabled
+template<class E, class G, class F>
+Tracer* Evaluator<E, G, F>::get_tracer() const {
+	return this->tracer.get();
+}
+
+#ifdef CGP_EVAL_COUNTERS
+/// @brief Returns the evaluation counters that are shared by the copies of the evaluator.
+/// @return shared pointer to the counters
+template<class E, class G, class F>
+const std::shared_ptr<EvalCounters>& Evaluator<E, G, F>::get_counters() const {
+	return this->counters;
+}
+#endif
+
 /// @brief Clears the maps used for decoding and creating the symbolic expression.
 template<class E, class G, class F>
 void Evaluator<E, G, F>::clear_maps() {
@@ -470,6 +565,16 @@ template<class E, class G, class F>
 void Evaluator<E, G, F>::decode_path(
 		std::shared_ptr<Individual<G, F>> individual) {
 
+	PhaseTimer::Scope scope(this->timer.get(), PhaseTimer::DECODE);
+	PerfCounters::Scope perf_scope(this->perf_counters.get(),
+			PerfCounters::DECODE);
+	AllocCounters::Scope alloc_scope(this->alloc_counters.get(),
+			AllocCounters::DECODE);
+
+#ifdef CGP_EVAL_COUNTERS
+	this->counters->count_decode();
+#endif
+
 	std::shared_ptr<std::vector<int>> active_nodes =
 			individual->get_active_nodes();
 
@@ -486,6 +591,8 @@ void Evaluator<E, G, F>::decode_path(
 	}
 
 	std::sort(active_nodes->begin(), active_nodes->end());
+
+	individual->set_decoded(true);
 }
 
 
@@ -16,11 +16,19 @@
 #include "../algorithm/EvolutionaryAlgorithm.h"
 #include "../initializer/LogicSynthesisInitializer.h"
 #include "../random/Random.h"
+#include "../profiling/MetricsServer.h"
+#include "../checkpoint/Manifest.h"
 
 #include <fstream>
 #include <sstream>
 #include <chrono>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <exception>
+#include <filesystem>
 
 using namespace std::chrono;
 
@@ -36,6 +44,7 @@ class Evolver {
 private:
 
 	int num_jobs;
+	int num_job_threads;
 
 	bool report_after_job;
 	bool report_during_job;
@@ -49,16 +58,26 @@ private:
 
 	std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> algorithm;
 	std::shared_ptr<AbstractPopulation<G, F>> population;
+	std::shared_ptr<MetricsServer> metrics_server;
 
 	void print_configuration();
+	void run_concurrent(std::shared_ptr<std::ofstream> ofs,
+			const Manifest &manifest);
+	std::string job_report(int job, std::pair<int, F> result,
+			double runtime,
+			std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> p_algorithm);
+	void write_report(const std::string &report,
+			std::shared_ptr<std::ofstream> ofs);
 
 public:
 	Evolver(std::shared_ptr<Initializer<E, G, F>> p_initializer);
 	virtual ~Evolver() = default;
 	std::string statfile_name();
+	std::string tracefile_name(int job);
 	void run();
 	void execute_job(int job, std::shared_ptr<std::ofstream> ofs);
 	void resume(std::string &checkpoint);
+	void resume_experiment(std::string &manifest_file);
 };
 
 template<class E, class G, class F>
@@ -74,6 +93,8 @@ Evolver<E, G, F>::Evolver(std::shared_ptr<Initializer<E, G, F>> p_initializer) {
 
 	parameters = composite->get_parameters();
 	num_jobs = parameters->get_num_jobs();
+	num_job_threads = std::max(1,
+			std::min(parameters->get_num_job_threads(), num_jobs));
 	report_after_job = this->parameters->is_report_after_job();
 	report_during_job = this->parameters->is_report_during_job();
 	report_simple = this->parameters->is_report_simple();
@@ -84,6 +105,12 @@ Evolver<E, G, F>::Evolver(std::shared_ptr<Initializer<E, G, F>> p_initializer) {
 
 	this->population = this->composite->get_population();
 	this->algorithm = this->initializer->get_algorithm();
+
+	// Serve the metrics of the running jobs if a socket path has been passed
+	if (!this->parameters->get_metrics_socket().empty()) {
+		this->metrics_server = std::make_shared<MetricsServer>(
+				this->parameters->get_metrics_socket());
+	}
 }
 
 /// @brief Prints the CGP++ configuration that has been defined for the experiment
@@ -118,6 +145,19 @@ std::string Evolver<E, G, F>::statfile_name() {
 	return ss.str();
 }
 
+/// @brief Generates an unique filename for the trace of a job with a timestamp 
+/// @param job The job number.
+/// @return Filename of the trace file
+template<class E, class G, class F>
+std::string Evolver<E, G, F>::tracefile_name(int job) {
+	std::stringstream ss;
+	uint64_t tstamp = duration_cast<milliseconds>(
+			system_clock::now().time_since_epoch()).count();
+	ss << this->parameters->TRACE_FILE_DIR << tstamp << "-job" << job
+			<< ".json";
+	return ss.str();
+}
+
 /// @brief Resumes a run instance from a checkpoint 
 /// @param checkpoint name of checkpoint file
 template<class E, class G, class F>
@@ -139,10 +179,18 @@ void Evolver<E, G, F>::resume(std::string &checkpoint) {
 				std::ofstream::out | std::fstream::trunc);
 	}
 
-	this->execute_job(1, ofs);
+	// The resumed job continues to write checkpoints into a new directory
+	if (this->parameters->is_checkpointing()) {
+		this->composite->get_checkpoint()->init();
+	}
+
+	this->algorithm->init_eval_processes();
 
-	ofs->close();
+	this->execute_job(1, ofs);
 
+	if (ofs != nullptr) {
+		ofs->close();
+	}
 }
 
 /// @brief  Runs the a experiment by executing the specified number of jobs.
@@ -162,30 +210,206 @@ void Evolver<E, G, F>::run() {
 				std::ofstream::out | std::fstream::trunc);
 	}
 
-	// Run the evolutionary algorithm for each job
-	for (int job = 1; job <= this->num_jobs; job++) {
+	// The jobs are run with isolated composites and seeds that are derived from
+	// the global seed, so the results do not depend on the number of job threads
+	this->run_concurrent(ofs,
+			Manifest(this->num_jobs, this->parameters->get_global_seed()));
+
+	if (ofs != nullptr) {
+		ofs->close();
+	}
+}
+
+/// @brief Resumes an experiment that has been stopped by a termination request.
+/// @details The number of jobs and the global seed are taken from the manifest. The 
+/// reports of the completed jobs are emitted again, so the statfile of the resumed 
+/// experiment contains the reports of all jobs. The stopped jobs continue from their 
+/// checkpoints and the jobs that have not been started are run from the beginning. 
+/// @param manifest_file path to the manifest file
+template<class E, class G, class F>
+void Evolver<E, G, F>::resume_experiment(std::string &manifest_file) {
+	Manifest manifest;
+	manifest.load(manifest_file);
+
+	this->num_jobs = manifest.get_num_jobs();
+	this->num_job_threads = std::max(1,
+			std::min(this->parameters->get_num_job_threads(), this->num_jobs));
+	this->parameters->set_num_jobs(this->num_jobs);
+	this->parameters->set_global_seed(manifest.get_global_seed());
+
+	if (this->parameters->is_print_configuration())
+		this->print_configuration();
+
+	std::cout << "Resuming experiment from manifest: " << manifest_file
+			<< std::endl << std::endl;
+
+	std::shared_ptr<std::ofstream> ofs;
+
+	if (this->parameters->is_write_statfile()) {
+		std::string statfile = this->statfile_name();
+		ofs = std::make_shared<std::ofstream>(statfile,
+				std::ofstream::out | std::fstream::trunc);
+	}
+
+	this->run_concurrent(ofs, manifest);
+
+	if (ofs != nullptr) {
+		ofs->close();
+	}
+}
+
+/// @brief Runs the jobs of the experiment with the configured number of job threads.
+/// @details Each job thread repeatedly claims the next job and builds an isolated
+/// composite for it with the initializer. The seed of a job is derived from the global 
+/// seed and the job number, so a job yields the same result regardless of the number
+/// of job threads and the order in which the jobs are claimed. Reports are
+/// emitted strictly in job order. The calling thread is one of the job threads, 
+/// so a single job thread runs the jobs one after another without another thread.
+/// 
+/// Once a termination has been requested, no further jobs are started and each 
+/// running job writes a checkpoint. The checkpoints, the reports of the completed 
+/// jobs and the seed are then stored in a manifest, from which the experiment can be 
+/// resumed, and a PreemptedException that carries the path of the manifest is thrown.
+/// @param ofs A shared pointer to the output file stream.
+/// @param manifest manifest of the experiment, which lists the completed and stopped 
+/// jobs if the experiment is resumed
+template<class E, class G, class F>
+void Evolver<E, G, F>::run_concurrent(std::shared_ptr<std::ofstream> ofs,
+		const Manifest &manifest) {
+
+	long long base_seed = manifest.get_global_seed();
 
-		// Reset the population and algorithm for each job after the first
-		if (job > 1) {
-			this->population->reset();
-			this->algorithm->reset();
+	std::vector<std::string> reports(this->num_jobs);
+	std::vector<bool> finished(this->num_jobs, false);
+	int next_report = 0;
+
+	Manifest stopped(this->num_jobs, base_seed);
+
+	// Completed jobs of a resumed experiment are only reported
+	for (int index = 0; index < this->num_jobs; index++) {
+		if (manifest.has_report(index + 1)) {
+			reports[index] = manifest.get_report(index + 1);
+			finished[index] = true;
+			stopped.add_report(index + 1, reports[index]);
 		}
+	}
+
+	while (next_report < this->num_jobs && finished[next_report]) {
+		this->write_report(reports[next_report], ofs);
+		next_report++;
+	}
 
-		if (this->parameters->is_checkpointing()) {
-			this->composite->get_checkpoint()->init();
+	std::atomic<int> next_job(0);
+	std::mutex report_mutex;
+	std::exception_ptr error = nullptr;
+
+	std::vector<std::thread> threads;
+
+	auto run_jobs = [&]() {
+		try {
+			int index;
+			while (!Preemption::is_requested()
+					&& (index = next_job++) < this->num_jobs) {
+				int job = index + 1;
+
+				if (manifest.has_report(job)) {
+					continue;
+				}
+
+				std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> job_algorithm =
+						this->initializer->init_job(job,
+								Random::derive_seed(base_seed, job),
+								manifest.has_checkpoint(job) ?
+										manifest.get_checkpoint(job) : "");
+
+				if (this->metrics_server != nullptr) {
+					job_algorithm->set_metrics(this->metrics_server->add(job));
+				}
+
+				std::pair<int, F> result;
+				std::chrono::duration<double> duration;
+
+				// Allocations of the job thread outside of the phases
+				{
+					AllocCounters::Scope alloc_scope(
+							job_algorithm->get_alloc_counters().get(),
+							AllocCounters::OTHER);
+
+					try {
+						auto start = std::chrono::high_resolution_clock::now();
+						result = job_algorithm->evolve();
+						auto end = std::chrono::high_resolution_clock::now();
+						duration = end - start;
+					} catch (const PreemptedException &e) {
+						if (this->metrics_server != nullptr) {
+							this->metrics_server->remove(job);
+						}
+
+						std::lock_guard<std::mutex> lock(report_mutex);
+						stopped.add_checkpoint(job, e.get_checkpoint_file());
+						continue;
+					}
+				}
+
+				if (this->metrics_server != nullptr) {
+					this->metrics_server->remove(job);
+				}
+
+				if (job_algorithm->get_tracer() != nullptr) {
+					job_algorithm->get_tracer()->write(
+							this->tracefile_name(job), job);
+				}
+
+				std::lock_guard<std::mutex> lock(report_mutex);
+				reports[index] = this->job_report(job, result, duration.count(),
+						job_algorithm);
+				finished[index] = true;
+				stopped.add_report(job, reports[index]);
+
+				// Flush all reports that are complete in job order
+				while (next_report < this->num_jobs && finished[next_report]) {
+					this->write_report(reports[next_report], ofs);
+					reports[next_report].clear();
+					next_report++;
+				}
+			}
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(report_mutex);
+			if (error == nullptr) {
+				error = std::current_exception();
+			}
+			next_job = this->num_jobs;
 		}
+	};
 
+	for (int i = 1; i < this->num_job_threads; i++) {
+		threads.push_back(std::thread(run_jobs));
+	}
 
-		this->execute_job(job, ofs);
+	run_jobs();
 
-		// Generate a new random seed if specified
-		if (this->parameters->is_generate_random_seed()) {
-			this->random->set_random_seed();
-		}
+	for (auto &t : threads) {
+		t.join();
+	}
 
+	if (error != nullptr) {
+		std::rethrow_exception(error);
 	}
 
-	ofs->close();
+	// Jobs are only left unfinished by a termination request
+	if (next_report < this->num_jobs) {
+		std::stringstream ss;
+		uint64_t tstamp = duration_cast<milliseconds>(
+				system_clock::now().time_since_epoch()).count();
+		ss << this->parameters->CHECKPOINT_FILE_DIR << tstamp
+				<< Manifest::EXTENSION;
+
+		std::filesystem::create_directories(
+				this->parameters->CHECKPOINT_FILE_DIR);
+		stopped.write(ss.str());
+
+		throw PreemptedException(ss.str());
+	}
 }
 
 /// @brief Executes a specific job
@@ -197,49 +421,119 @@ void Evolver<E, G, F>::execute_job(int job,
 		std::shared_ptr<std::ofstream> ofs) {
 
 	std::pair<int, F> result;
-	std::stringstream ss;
 	std::chrono::duration<double> duration;
 
-	// Start EA and measures the runtime
-	auto start = std::chrono::high_resolution_clock::now();
-	result = algorithm->evolve();
-	auto end = std::chrono::high_resolution_clock::now();
+	if (this->metrics_server != nullptr) {
+		this->algorithm->set_metrics(this->metrics_server->add(job));
+	}
+
+	// Start EA and measures the runtime, the allocations of the job thread
+	// outside of the phases are counted as other
+	{
+		AllocCounters::Scope alloc_scope(
+				this->algorithm->get_alloc_counters().get(),
+				AllocCounters::OTHER);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		result = algorithm->evolve();
+		auto end = std::chrono::high_resolution_clock::now();
 
-	duration = end - start;
+		duration = end - start;
+	}
+
+	if (this->metrics_server != nullptr) {
+		this->metrics_server->remove(job);
+	}
+
+	// Write the timeline of the job if tracing is enabled
+	if (this->algorithm->get_tracer() != nullptr) {
+		this->algorithm->get_tracer()->write(this->tracefile_name(job), job);
+	}
+
+	this->write_report(
+			this->job_report(job, result, duration.count(), this->algorithm),
+			ofs);
+}
+
+/// @brief Creates the report of a finished job. 
+/// @param job The job number.
+/// @param result number of fitness evaluations and best fitness of the job
+/// @param runtime runtime of the job in seconds 
+/// @param p_algorithm algorithm that has executed the job
+/// @return report of the job, empty if no reporting after the job is desired
+template<class E, class G, class F>
+std::string Evolver<E, G, F>::job_report(int job, std::pair<int, F> result,
+		double runtime,
+		std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> p_algorithm) {
+
+	std::stringstream ss;
+
+	// Time spent in the phases of the job, if phase timing is enabled, the
+	// hardware performance counters, if they are enabled, and the evaluation
+	// and allocation counters, if they are compiled in
+	std::string profile;
+	if (p_algorithm->get_phase_timer() != nullptr) {
+		profile = p_algorithm->get_phase_timer()->to_string(this->report_simple);
+	}
+
+	if (p_algorithm->get_perf_counters() != nullptr) {
+		profile += p_algorithm->get_perf_counters()->to_string(
+				this->report_simple);
+	}
+
+#ifdef CGP_EVAL_COUNTERS
+	profile += p_algorithm->get_eval_counters()->to_string(this->report_simple);
+#endif
+
+	if (p_algorithm->get_alloc_counters() != nullptr) {
+		profile += p_algorithm->get_alloc_counters()->to_string(
+				this->report_simple, p_algorithm->get_generation_number());
+	}
 
 	// Do reporting after the job if desired. 
 	if (this->report_after_job) {
 		if (this->report_simple) {
 			if (this->simple_report_type
 					== this->parameters->FITNESS_EVALUATIONS_TO_TERMINATION) {
-				ss << result.first << std::endl;
+				ss << result.first << profile << std::endl;
 			} else {
-				ss << result.second << std::endl;
+				ss << result.second << profile << std::endl;
 			}
 		} else {
 			ss << "Job # " << job << " :: Evaluations: " << result.first
 					<< " :: Best Fitness: " << result.second
-					<< " :: Runtime (s): " << duration.count() << std::endl;
+					<< " :: Runtime (s): " << runtime
+					<< " :: Evaluations/s: " << result.first / runtime
+					<< profile << std::endl;
 		}
 	}
 
+	return ss.str();
+}
+
+/// @brief Prints the report of a job and writes it to the statfile if desired. 
+/// @param report report of the job
+/// @param ofs A shared pointer to the output file stream.
+template<class E, class G, class F>
+void Evolver<E, G, F>::write_report(const std::string &report,
+		std::shared_ptr<std::ofstream> ofs) {
+
 	if (this->report_during_job)
 		std::cout << std::endl;
 
-	std::cout << ss.str();
+	std::cout << report;
 
 	if (this->report_during_job)
 		std::cout << std::endl << std::endl;
 
 	// Write to statfile if desired. 
 	if (this->parameters->is_write_statfile()) {
-		*ofs << ss.rdbuf();
-	}
+		*ofs << report;
 
-	if (!ofs->good()) {
-		throw std::runtime_error("Error while writing benchmark file!");
+		if (!ofs->good()) {
+			throw std::runtime_error("Error while writing benchmark file!");
+		}
 	}
-
 }
 
 #endif /* EVOLVER_EVOLVER_H_ */
@@ -0,0 +1,243 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: stand-in-evaluator.cpp
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+// Stand-in for an external fitness evaluator that speaks the batch protocol
+// of the ExternalProblem class on its standard input and output. It evaluates
+// the received phenotypes on a logic synthesis benchmark with the Hamming
+// distance, which gives the same fitness as the in-process evaluation.
+//
+// usage: cgp-stand-in-evaluator DATAFILE
+//
+// Example: ./cgp data/plufiles/add1c.plu data/parfiles/cgp.params ...
+//          -x "./cgp-stand-in-evaluator data/plufiles/add1c.plu"
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+#include <unistd.h>
+
+#include "../benchmark/BenchmarkFileReader.h"
+#include "../functions/BooleanFunctions.h"
+#include "../parameters/Parameters.h"
+
+typedef long EVALUATION_TYPE;
+
+enum MessageType : uint32_t {
+	HELLO = 1, BATCH = 2, RESULTS = 3, SHUTDOWN = 4
+};
+
+struct Header {
+	uint32_t type;
+	uint32_t id;
+	uint32_t count;
+	uint32_t payload_size;
+};
+
+/// @brief Reads exactly size bytes from the standard input.
+/// @return false if the input has been closed
+bool read_all(void *data, std::size_t size) {
+	char *bytes = static_cast<char*>(data);
+	while (size > 0) {
+		ssize_t received = read(STDIN_FILENO, bytes, size);
+		if (received <= 0) {
+			return false;
+		}
+		bytes += received;
+		size -= received;
+	}
+	return true;
+}
+
+/// @brief Writes exactly size bytes to the standard output.
+void write_all(const void *data, std::size_t size) {
+	const char *bytes = static_cast<const char*>(data);
+	while (size > 0) {
+		ssize_t written = write(STDOUT_FILENO, bytes, size);
+		if (written <= 0) {
+			throw std::runtime_error("Could not write the results!");
+		}
+		bytes += written;
+		size -= written;
+	}
+}
+
+/// @brief Reads a value in host byte order from a payload.
+template<class T>
+T get(const std::vector<char> &payload, std::size_t &offset) {
+	if (offset + sizeof(T) > payload.size()) {
+		throw std::runtime_error("Truncated message!");
+	}
+	T value;
+	std::memcpy(&value, payload.data() + offset, sizeof(T));
+	offset += sizeof(T);
+	return value;
+}
+
+int main(int argc, char **argv) {
+
+	if (argc < 2) {
+		std::cerr << "usage: " << argv[0] << " DATAFILE" << std::endl;
+		return 1;
+	}
+
+	BenchmarkFileReader<EVALUATION_TYPE> reader;
+	reader.read_benchmark_file(argv[1]);
+
+	std::shared_ptr<std::vector<std::vector<EVALUATION_TYPE>>> inputs =
+			reader.get_input_data();
+	std::shared_ptr<std::vector<std::vector<EVALUATION_TYPE>>> outputs =
+			reader.get_output_data();
+
+	std::shared_ptr<Parameters> parameters = std::make_shared<Parameters>();
+	parameters->set_max_arity(2);
+	FunctionsBoolean<EVALUATION_TYPE> functions(parameters);
+
+	Header header;
+	std::vector<char> payload;
+
+	// Handshake: map the functions of CGP++ to the own function set by name
+	if (!read_all(&header, sizeof(Header)) || header.type != HELLO) {
+		std::cerr << "Expected handshake!" << std::endl;
+		return 1;
+	}
+
+	payload.resize(header.payload_size);
+	read_all(payload.data(), payload.size());
+
+	std::size_t offset = 0;
+	uint32_t version = get<uint32_t>(payload, offset);
+	uint32_t num_inputs = get<uint32_t>(payload, offset);
+	uint32_t num_variables = get<uint32_t>(payload, offset);
+	uint32_t num_outputs = get<uint32_t>(payload, offset);
+	uint32_t num_functions = get<uint32_t>(payload, offset);
+	uint32_t value_size = get<uint32_t>(payload, offset);
+
+	if (version != 2 || (int) num_variables != reader.get_num_inputs()
+			|| num_inputs < num_variables
+			|| (int) num_outputs != reader.get_num_outputs()
+			|| value_size != sizeof(EVALUATION_TYPE)) {
+		std::cerr << "Configuration does not match the benchmark!" << std::endl;
+		return 1;
+	}
+
+	std::vector<int> function_map;
+	std::vector<int> arities;
+
+	for (uint32_t i = 0; i < num_functions; i++) {
+		int arity = get<uint8_t>(payload, offset);
+		uint16_t length = get<uint16_t>(payload, offset);
+		std::string name(payload.data() + offset, length);
+		offset += length;
+
+		int function = -1;
+		for (int j = 0; j < 4; j++) {
+			if (functions.function_name(j) == name) {
+				function = j;
+			}
+		}
+
+		if (function < 0) {
+			std::cerr << "Unknown function " << name << "!" << std::endl;
+			return 1;
+		}
+
+		function_map.push_back(function);
+		arities.push_back(arity);
+	}
+
+	// The constants follow the variables as inputs of the programs
+	std::vector<EVALUATION_TYPE> constants;
+
+	for (uint32_t i = num_variables; i < num_inputs; i++) {
+		constants.push_back(get<EVALUATION_TYPE>(payload, offset));
+	}
+
+	Header reply { HELLO, 0, 0, 0 };
+	write_all(&reply, sizeof(Header));
+
+	// Same number of compared bits per chunk as the logic synthesis problem
+	int num_bits = std::min((int) std::pow(2, num_variables), 32);
+
+	std::vector<EVALUATION_TYPE> values;
+	std::vector<double> fitness;
+
+	while (read_all(&header, sizeof(Header)) && header.type == BATCH) {
+
+		payload.resize(header.payload_size);
+		if (!read_all(payload.data(), payload.size())) {
+			return 1;
+		}
+
+		offset = 0;
+		fitness.assign(header.count, 0.0);
+
+		for (uint32_t p = 0; p < header.count; p++) {
+
+			// Flatten the program: function and connections of each active node
+			uint32_t num_nodes = get<uint32_t>(payload, offset);
+			std::vector<int> node_functions(num_nodes);
+			std::vector<std::vector<uint32_t>> node_inputs(num_nodes);
+
+			for (uint32_t n = 0; n < num_nodes; n++) {
+				uint16_t function = get<uint16_t>(payload, offset);
+				node_functions[n] = function_map.at(function);
+				for (int a = 0; a < arities.at(function); a++) {
+					node_inputs[n].push_back(get<uint32_t>(payload, offset));
+				}
+			}
+
+			std::vector<uint32_t> output_connections(num_outputs);
+			for (uint32_t o = 0; o < num_outputs; o++) {
+				output_connections[o] = get<uint32_t>(payload, offset);
+			}
+
+			double diff = 0;
+
+			for (int i = 0; i < reader.get_num_instances(); i++) {
+				values.assign(inputs->at(i).begin(), inputs->at(i).end());
+				values.insert(values.end(), constants.begin(), constants.end());
+
+				for (uint32_t n = 0; n < num_nodes; n++) {
+					EVALUATION_TYPE arguments[2] = { 0, 0 };
+					for (std::size_t a = 0; a < node_inputs[n].size(); a++) {
+						arguments[a] = values.at(node_inputs[n][a]);
+					}
+					values.push_back(
+							functions.call_function(arguments, node_functions[n]));
+				}
+
+				for (uint32_t o = 0; o < num_outputs; o++) {
+					EVALUATION_TYPE compare = values.at(output_connections[o])
+							^ outputs->at(i).at(o);
+					for (int j = 0; j < num_bits; j++) {
+						diff += (compare >> j) & 1;
+					}
+				}
+			}
+
+			fitness[p] = diff;
+		}
+
+		reply = { RESULTS, header.id, header.count,
+				(uint32_t) (header.count * sizeof(double)) };
+		write_all(&reply, sizeof(Header));
+		write_all(fitness.data(), fitness.size() * sizeof(double));
+	}
+
+	return 0;
+}
@@ -15,19 +15,19 @@
 
 #include <string>
 #include "Initializer.h"
+#include "../benchmark/DatasetCache.h"
 
 template<class E, class G, class F>
 class BlackBoxInitializer: public Initializer<E, G, F> {
 protected:
-	std::shared_ptr<std::vector<std::vector<E>> > inputs;
-	std::shared_ptr<std::vector<std::vector<E>> > outputs;
-	int num_instances;
+	std::shared_ptr<Dataset<E>> dataset;
 public:
 	BlackBoxInitializer(const std::string &p_benchmark_file);
 	virtual ~BlackBoxInitializer() = default;
-	virtual void init_problem() = 0;
+	virtual std::shared_ptr<BlackBoxProblem<E, G, F>> create_problem(
+			std::shared_ptr<Composite<E, G, F>> p_composite) = 0;
 	virtual void init_functions() = 0;
-	void read_data();
+	virtual void read_data();
 };
 
 template<class E, class G, class F>
@@ -36,23 +36,19 @@ BlackBoxInitializer<E, G, F>::BlackBoxInitializer(
 		Initializer<E, G, F>(p_benchmark_file) {
 }
 
+/// @brief Reads the dataset of the benchmark file.
+/// @details Uses the binary dataset cache unless it is deactivated.
 template<class E, class G, class F>
 void BlackBoxInitializer<E, G, F>::read_data() {
 
-	std::shared_ptr<BenchmarkFileReader<E>> bechmark_reader = std::make_shared<
-			BenchmarkFileReader<E>>();
+	if (this->parameters->is_dataset_cache()) {
+		this->dataset = DatasetCache<E>::load(this->benchmark_file);
+	} else {
+		this->dataset = DatasetCache<E>::read(this->benchmark_file);
+	}
 
-	bechmark_reader->read_benchmark_file(this->benchmark_file);
-
-	this->inputs = bechmark_reader->get_input_data();
-	this->outputs = bechmark_reader->get_output_data();
-
-	int num_inputs = bechmark_reader->get_num_inputs();
-	int num_outputs = bechmark_reader->get_num_outputs();
-
-	this->parameters->set_num_variables(num_inputs);
-	this->parameters->set_num_outputs(num_outputs);
-	this->num_instances = bechmark_reader->get_num_instances();
+	this->parameters->set_num_variables(this->dataset->get_num_inputs());
+	this->parameters->set_num_outputs(this->dataset->get_num_outputs());
 }
 
 #endif /* INITIALIZER_BLACKBOXINITIALIZER_H_ */
@@ -24,9 +24,11 @@
 #include "../fitness/Fitness.h"
 #include "../mutation/Mutation.h"
 #include "../problems/BlackBoxProblem.h"
+#include "../problems/ExternalProblem.h"
 #include "../algorithm/EvolutionaryAlgorithm.h"
 #include "../algorithm/OnePlusLambda.h"
 #include "../algorithm/MuPlusLambda.h"
+#include "../algorithm/AsynchronousSteadyState.h"
 #include "../composite/Composite.h"
 #include "../population/StaticPopulation.h"
 #include "../functions/Functions.h"
@@ -79,8 +81,19 @@ public:
 	void init_algorithm();
 	void init_checkpoint();
 	void init_checkpoint_file(std::string &checkpoint_file);
-	virtual void init_problem() = 0;
+	void init_problem();
 	virtual void init_functions() = 0;
+
+	void generate_erc(std::shared_ptr<Composite<E, G, F>> p_composite);
+	std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> create_algorithm(
+			std::shared_ptr<Composite<E, G, F>> p_composite);
+	virtual std::shared_ptr<BlackBoxProblem<E, G, F>> create_problem(
+			std::shared_ptr<Composite<E, G, F>> p_composite) = 0;
+	std::shared_ptr<BlackBoxProblem<E, G, F>> create_evaluated_problem(
+			std::shared_ptr<Composite<E, G, F>> p_composite);
+
+	std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> init_job(int job,
+			long long seed, std::string checkpoint_file = "");
 };
 
 /// @brief Constructor that instantiates the parameter object. 
@@ -141,6 +154,8 @@ void Initializer<E, G, F>::init_parfile_parameters(std::string parfile_path) {
 
 			if (parameter == "algorithm") {
 				this->parameters->set_algorithm(value);
+			} else if (parameter == "levels_back") {
+				this->parameters->set_levels_back(value);
 			} else if (parameter == "num_function_nodes") {
 				this->parameters->set_num_function_nodes(value);
 			} else if (parameter == "num_variables") {
@@ -205,20 +220,48 @@ void Initializer<E, G, F>::init_parfile_parameters(std::string parfile_path) {
 				this->parameters->set_report_simple(state);
 			} else if (parameter == "report_interval") {
 				this->parameters->set_report_interval(value);
+			} else if (parameter == "phase_timing") {
+				this->parameters->set_phase_timing(state);
+			} else if (parameter == "perf_counters") {
+				this->parameters->set_perf_counters(state);
 			} else if (parameter == "simple_report_type") {
 				this->parameters->set_simple_report_type(value);
 			} else if (parameter == "generate_random_seed") {
 				this->parameters->set_generate_random_seed(state);
 			} else if (parameter == "write_statfile") {
 				this->parameters->set_write_statfile(state);
+			} else if (parameter == "write_tracefile") {
+				this->parameters->set_write_tracefile(state);
 			} else if (parameter == "global_seed") {
 				this->parameters->set_global_seed(value);
 			} else if (parameter == "num_eval_threads") {
 				this->parameters->set_num_eval_threads(value);
+			} else if (parameter == "pin_eval_threads") {
+				this->parameters->set_pin_eval_threads(state);
+			} else if (parameter == "numa_replicate_data") {
+				this->parameters->set_numa_replicate_data(state);
+			} else if (parameter == "dataset_cache") {
+				this->parameters->set_dataset_cache(state);
+			} else if (parameter == "dataset_block_size") {
+				this->parameters->set_dataset_block_size(value);
+			} else if (parameter == "num_eval_processes") {
+				this->parameters->set_num_eval_processes(value);
+			} else if (parameter == "external_batch_size") {
+				this->parameters->set_external_batch_size(value);
+			} else if (parameter == "external_batches_in_flight") {
+				this->parameters->set_external_batches_in_flight(value);
+			} else if (parameter == "num_job_threads") {
+				this->parameters->set_num_job_threads(value);
+			} else if (parameter == "pipelined_evaluation") {
+				this->parameters->set_pipelined_evaluation(state);
 			} else if (parameter == "checkpointing") {
 				this->parameters->set_checkpointing(state);
 			} else if (parameter == "checkpoint_modulo") {
 				this->parameters->set_checkpoint_modulo(value);
+			} else if (parameter == "checkpoint_format") {
+				this->parameters->set_checkpoint_format(value);
+			} else if (parameter == "checkpoint_delta_encoding") {
+				this->parameters->set_checkpoint_delta_encoding(state);
 			}
 		}
 	} else {
@@ -339,19 +382,25 @@ void Initializer<E, G, F>::finalize_parameter_configuration() {
 /// @brief Inits the number of ERC's according to the predefined type. 
 template<class E, class G, class F>
 void Initializer<E, G, F>::init_erc() {
-	int num_constants = this->parameters->get_num_constants();
-	ERC_TYPE type = this->parameters->get_erc_type();
+	this->generate_erc(this->composite);
+	this->constants = this->composite->get_constants();
+}
+
+/// @brief Generates the ERC's of a composite by using its random generator. 
+/// @param p_composite composite that receives the constants 
+template<class E, class G, class F>
+void Initializer<E, G, F>::generate_erc(
+		std::shared_ptr<Composite<E, G, F>> p_composite) {
+	int num_constants = p_composite->get_parameters()->get_num_constants();
+	ERC_TYPE type = p_composite->get_parameters()->get_erc_type();
 
-	std::shared_ptr<Random> random = this->composite->get_random();
-	std::shared_ptr<std::vector<E>> constants =
-			this->composite->get_constants();
+	std::shared_ptr<Random> random = p_composite->get_random();
+	std::shared_ptr<std::vector<E>> constants = p_composite->get_constants();
 
 	for (int i = 0; i < num_constants; i++) {
 		E erc = ERC::generate_ERC(random, type);
 		constants->push_back(erc);
 	}
-
-	this->constants = constants;
 }
 
 /// @brief Inits the composite class 
@@ -363,24 +412,111 @@ void Initializer<E, G, F>::init_composite() {
 	this->evaluator = composite->get_evaluator();
 }
 
+/// @brief Inits the problem instance of the composite. 
+template<class E, class G, class F>
+void Initializer<E, G, F>::init_problem() {
+	this->problem = this->create_evaluated_problem(this->composite);
+	this->composite->set_problem(this->problem);
+}
+
+/// @brief Creates the problem instance of a composite that is used for the evaluation. 
+/// @details If an external evaluator has been passed, the fitness is computed by the 
+/// external evaluator process instead of the problem of the domain. 
+/// @param p_composite composite that provides the evaluator, functions and constants
+/// @return shared pointer to the problem instance
+template<class E, class G, class F>
+std::shared_ptr<BlackBoxProblem<E, G, F>> Initializer<E, G, F>::create_evaluated_problem(
+		std::shared_ptr<Composite<E, G, F>> p_composite) {
+
+	std::shared_ptr<Parameters> parameters = p_composite->get_parameters();
+
+	if (parameters->is_external_evaluation()) {
+		return std::make_shared<ExternalProblem<E, G, F>>(parameters,
+				p_composite->get_evaluator(), p_composite->get_functions(),
+				p_composite->get_constants(),
+				parameters->get_external_evaluator());
+	}
+
+	return this->create_problem(p_composite);
+}
+
 /// @brief Inits the evolutionary algorithm 
+template<class E, class G, class F>
+void Initializer<E, G, F>::init_algorithm() {
+	this->algorithm = this->create_algorithm(this->composite);
+}
+
+/// @brief Creates the evolutionary algorithm for a composite. 
 /// @details The algorithm is instantiated according to the type setting 
 /// in the parameter object. 
+/// @param p_composite composite the algorithm operates on
+/// @return shared pointer to the algorithm 
 template<class E, class G, class F>
-void Initializer<E, G, F>::init_algorithm() {
-	if (this->parameters->get_algorithm()
-			== this->parameters->ONE_PLUS_LAMBDA) {
-		this->algorithm = std::make_shared<OnePlusLambda<E, G, F>>(
-				this->composite);
-	} else if (this->parameters->get_algorithm()
-			== this->parameters->MU_PLUS_LAMBDA) {
-		this->algorithm = std::make_shared<MuPlusLambda<E, G, F>>(
-				this->composite);
+std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> Initializer<E, G, F>::create_algorithm(
+		std::shared_ptr<Composite<E, G, F>> p_composite) {
+	std::shared_ptr<Parameters> parameters = p_composite->get_parameters();
+
+	if (parameters->get_algorithm() == parameters->ONE_PLUS_LAMBDA) {
+		return std::make_shared<OnePlusLambda<E, G, F>>(p_composite);
+	} else if (parameters->get_algorithm() == parameters->MU_PLUS_LAMBDA) {
+		return std::make_shared<MuPlusLambda<E, G, F>>(p_composite);
+	} else if (parameters->get_algorithm() == parameters->ASYNC_STEADY_STATE) {
+		return std::make_shared<AsynchronousSteadyState<E, G, F>>(p_composite);
 	} else {
 		throw std::invalid_argument("Unknown algorithm!");
 	}
 }
 
+/// @brief Builds an isolated instance of the elements required to execute a job. 
+/// @details Used to run jobs concurrently. Each job obtains its own copy of the 
+/// parameters, its own random generator seeded with the passed seed and therefore its
+/// own population, constants, evaluator, problem and checkpoint directory. Only the 
+/// read-only dataset and the function set are shared with the other jobs. A job that 
+/// has been stopped by a termination request is restored from its checkpoint. 
+/// The evaluation processes of the job are forked last. 
+/// @param job job number 
+/// @param seed seed of the random generator of the job 
+/// @param checkpoint_file path to the checkpoint file of the job or empty to start the job
+/// @return shared pointer to the algorithm of the job 
+template<class E, class G, class F>
+std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> Initializer<E, G, F>::init_job(
+		int job, long long seed, std::string checkpoint_file) {
+
+	std::shared_ptr<Parameters> job_parameters = std::make_shared<Parameters>(
+			*this->parameters);
+	job_parameters->set_generate_random_seed(false);
+	job_parameters->set_global_seed(seed);
+
+	std::shared_ptr<Composite<E, G, F>> job_composite = std::make_shared<
+			Composite<E, G, F>>(job_parameters, this->functions);
+
+	this->generate_erc(job_composite);
+	job_composite->set_problem(this->create_evaluated_problem(job_composite));
+
+	std::shared_ptr<Checkpoint<E, G, F>> job_checkpoint = std::make_shared<
+			Checkpoint<E, G, F>>(job_parameters, job);
+	job_composite->set_checkpoint(job_checkpoint);
+
+	if (job_parameters->is_checkpointing()) {
+		job_checkpoint->init(job);
+	}
+
+	std::shared_ptr<EvolutionaryAlgorithm<E, G, F>> job_algorithm =
+			this->create_algorithm(job_composite);
+
+	if (!checkpoint_file.empty()) {
+		CheckpointState<F> state = job_checkpoint->load(
+				job_composite->get_population(), job_composite->get_constants(),
+				job_composite->get_random(), checkpoint_file);
+		job_algorithm->restore(state);
+	}
+
+	// Fork the evaluation processes before the job starts its threads
+	job_algorithm->init_eval_processes();
+
+	return job_algorithm;
+}
+
 /// @brief Inits the checkpointer.
 /// @details Sets the checkpointer in the composite. 
 template<class E, class G, class F>
@@ -393,10 +529,10 @@ void Initializer<E, G, F>::init_checkpoint() {
 /// @param checkpoint_file path to the checkpoint file 
 template<class E, class G, class F>
 void Initializer<E, G, F>::init_checkpoint_file(std::string &checkpoint_file) {
-	int generation_number = this->checkpoint->load(
+	CheckpointState<F> state = this->checkpoint->load(
 			this->composite->get_population(), this->composite->get_constants(),
 			this->composite->get_random(), checkpoint_file);
-	this->algorithm->set_generation_number(generation_number);
+	this->algorithm->restore(state);
 	std::cout << "Loaded chekpoint file " << checkpoint_file << std::endl
 			<< std::endl;
 }
@@ -32,7 +32,8 @@ class LogicSynthesisInitializer: public  BlackBoxInitializer<E, G, F> {
 public:
 	LogicSynthesisInitializer(const std::string &p_benchmark_file);
 	~LogicSynthesisInitializer() = default;
-	void init_problem() override;
+	std::shared_ptr<BlackBoxProblem<E, G, F>> create_problem(
+			std::shared_ptr<Composite<E, G, F>> p_composite) override;
 	void init_functions() override;
 };
 
@@ -42,15 +43,15 @@ LogicSynthesisInitializer<E, G, F>::LogicSynthesisInitializer(
 		BlackBoxInitializer<E, G, F>(p_benchmark_file) {
 }
 
-/// @brief Initializes the logic synthesis problem instance. 
+/// @brief Creates the logic synthesis problem instance of a composite. 
+/// @param p_composite composite that provides the evaluator and constants
+/// @return shared pointer to the problem instance
 template<class E, class G, class F>
-void LogicSynthesisInitializer<E, G, F>::init_problem() {
-
-	std::shared_ptr<LogicSynthesisProblem<E, G, F>> problem = std::make_shared<
-			LogicSynthesisProblem<E, G, F>>(this->parameters, this->evaluator,
-			this->inputs, this->outputs, this->constants, this->num_instances);
-
-	this->composite->set_problem(problem);
+std::shared_ptr<BlackBoxProblem<E, G, F>> LogicSynthesisInitializer<E, G, F>::create_problem(
+		std::shared_ptr<Composite<E, G, F>> p_composite) {
+	return std::make_shared<LogicSynthesisProblem<E, G, F>>(p_composite->get_parameters(),
+			p_composite->get_evaluator(), this->dataset,
+			p_composite->get_constants());
 }
 
 
@@ -25,11 +25,16 @@
 /// @tparam F Fitness Type 
 template<class E, class G, class F>
 class SymbolicRegressionInitializer: public BlackBoxInitializer<E, G, F> {
+protected:
+	std::shared_ptr<DatasetStream<E>> stream;
+
 public:
 	SymbolicRegressionInitializer(const std::string &p_benchmark_file);
 	~SymbolicRegressionInitializer()  = default;
-	void init_problem() override;
+	std::shared_ptr<BlackBoxProblem<E, G, F>> create_problem(
+			std::shared_ptr<Composite<E, G, F>> p_composite) override;
 	void init_functions() override;
+	void read_data() override;
 };
 
 template<class E, class G, class F>
@@ -38,14 +43,42 @@ SymbolicRegressionInitializer<E, G, F>::SymbolicRegressionInitializer(
 		BlackBoxInitializer<E, G, F>(p_benchmark_file) {
 }
 
-/// @brief Initializes the funcion set used for symbolic regression problems. 
+/// @brief Creates the symbolic regression problem instance of a composite. 
+/// @param p_composite composite that provides the evaluator and constants
+/// @return shared pointer to the problem instance
+template<class E, class G, class F>
+std::shared_ptr<BlackBoxProblem<E, G, F>> SymbolicRegressionInitializer<E, G, F>::create_problem(
+		std::shared_ptr<Composite<E, G, F>> p_composite) {
+	if (this->stream != nullptr) {
+		return std::make_shared<SymbolicRegressionProblem<E, G, F>>(
+				p_composite->get_parameters(), p_composite->get_evaluator(),
+				std::make_shared<DatasetStream<E>>(*this->stream),
+				p_composite->get_constants());
+	}
+
+	return std::make_shared<SymbolicRegressionProblem<E, G, F>>(p_composite->get_parameters(),
+			p_composite->get_evaluator(), this->dataset,
+			p_composite->get_constants());
+}
+
+/// @brief Reads the dataset or, if a block size is set, opens a stream over it. 
+/// @details The block size is rounded up to a multiple of the fitness case shard size.
 template<class E, class G, class F>
-void SymbolicRegressionInitializer<E, G, F>::init_problem() {
-	std::shared_ptr<SymbolicRegressionProblem<E, G, F>> problem = std::make_shared<
-			SymbolicRegressionProblem<E, G, F>>(this->parameters, this->evaluator,
-			this->inputs, this->outputs, this->constants, this->num_instances);
+void SymbolicRegressionInitializer<E, G, F>::read_data() {
+	int block_size = this->parameters->get_dataset_block_size();
+
+	if (block_size == 0) {
+		BlackBoxInitializer<E, G, F>::read_data();
+		return;
+	}
+
+	int shard_size = this->parameters->FITNESS_CASE_SHARD_SIZE;
+	block_size = (block_size + shard_size - 1) / shard_size * shard_size;
+
+	this->stream = DatasetCache<E>::stream(this->benchmark_file, block_size);
 
-	this->composite->set_problem(problem);
+	this->parameters->set_num_variables(this->stream->get_num_inputs());
+	this->parameters->set_num_outputs(this->stream->get_num_outputs());
 }
 
 template<class E, class G, class F>
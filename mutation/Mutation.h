@@ -87,6 +87,7 @@ Mutation<G, F>::Mutation(std::shared_ptr<Parameters> p_parameters,
 template<class G, class F>
 void Mutation<G, F>::mutate(std::shared_ptr<Individual<G, F>> parent) {
 	this->pipeline->breed(parent);
+	parent->set_decoded(false);
 }
 
 template<class G, class F>
@@ -13,6 +13,7 @@
 #include "Parameters.h"
 
 #include <cmath>
+#include <algorithm>
 
 Parameters::Parameters() {
 	algorithm = -1;
@@ -39,22 +40,36 @@ Parameters::Parameters() {
 	max_duplication_depth = -1;
 
 	num_jobs = 1;
+	num_job_threads = 1;
 	num_eval_threads = 1;
+	pin_eval_threads = false;
+	numa_replicate_data = false;
+	dataset_cache = true;
+	dataset_block_size = 0;
+	num_eval_processes = 1;
+	external_batch_size = 32;
+	external_batches_in_flight = 2;
 	max_generations = -1;
 	max_fitness_evaluations = -1;
 	ideal_fitness = 0;
 
 	neutral_genetic_drift = true;
+	pipelined_evaluation = false;
 
 	evaluate_expression = false;
 	minimizing_fitness = true;
 	report_during_job = false;
 	report_after_job = true;
 	report_simple = true;
+	phase_timing = false;
+	perf_counters = false;
 	report_interval = 1;
 	print_configuration = false;
 	write_statfile = false;
+	write_tracefile = false;
 	checkpointing = false;
+	checkpoint_format = BINARY_CHECKPOINT;
+	checkpoint_delta_encoding = true;
 
 	simple_report_type = BEST_FITNESS_OF_RUN;
 
@@ -96,6 +111,7 @@ void Parameters::print() {
 	std::cout << std::endl;
 
 	std::cout << "Number of jobs: " << num_jobs << std::endl;
+	std::cout << "Number of concurrent jobs: " << num_job_threads << std::endl;
 	std::cout << "Maximum number of fitness evaluations: "
 			<< max_fitness_evaluations << std::endl;
 	std::cout << "Maximum number of generations: " << max_generations
@@ -111,8 +127,9 @@ void Parameters::print() {
 // ------------------------------------------------------------------------------------------
 
 void Parameters::set_eval_chunk_size() {
-	assert(this->num_eval_threads <= this->population_size);
-	this->eval_chunk_size = std::trunc(
+	// More threads than individuals are allowed since the fitness cases
+	// of an individual can be evaluated concurrently
+	this->eval_chunk_size = std::max(1,
 			this->population_size / this->num_eval_threads);
 }
 
@@ -344,6 +361,10 @@ int Parameters::get_num_jobs() const {
 	return this->num_jobs;
 }
 
+int Parameters::get_num_job_threads() const {
+	return this->num_job_threads;
+}
+
 int Parameters::get_num_eval_threads() const {
 	return this->num_eval_threads;
 }
@@ -380,6 +401,14 @@ void Parameters::set_neutral_genetic_drift(bool p_neutral_genetic_drift) {
 	this->neutral_genetic_drift = p_neutral_genetic_drift;
 }
 
+bool Parameters::is_pipelined_evaluation() const {
+	return this->pipelined_evaluation;
+}
+
+void Parameters::set_pipelined_evaluation(bool p_pipelined_evaluation) {
+	this->pipelined_evaluation = p_pipelined_evaluation;
+}
+
 void Parameters::set_evaluate_expression(bool p_evaluate_expression) {
 	this->evaluate_expression = p_evaluate_expression;
 }
@@ -392,6 +421,22 @@ void Parameters::set_report_simple(bool P_report_simple) {
 	this->report_simple = P_report_simple;
 }
 
+bool Parameters::is_phase_timing() const {
+	return this->phase_timing;
+}
+
+void Parameters::set_phase_timing(bool p_phase_timing) {
+	this->phase_timing = p_phase_timing;
+}
+
+bool Parameters::is_perf_counters() const {
+	return this->perf_counters;
+}
+
+void Parameters::set_perf_counters(bool p_perf_counters) {
+	this->perf_counters = p_perf_counters;
+}
+
 void Parameters::set_report_after_job(bool p_report_after_job) {
 	this->report_after_job = p_report_after_job;
 }
@@ -410,6 +455,95 @@ void Parameters::set_num_jobs(int p_num_jobs) {
 	this->num_jobs = p_num_jobs;
 }
 
+void Parameters::set_num_job_threads(int p_num_job_threads) {
+	assert(p_num_job_threads > 0);
+	this->num_job_threads = p_num_job_threads;
+}
+
+bool Parameters::is_pin_eval_threads() const {
+	return this->pin_eval_threads;
+}
+
+void Parameters::set_pin_eval_threads(bool p_pin_eval_threads) {
+	this->pin_eval_threads = p_pin_eval_threads;
+}
+
+bool Parameters::is_numa_replicate_data() const {
+	return this->numa_replicate_data;
+}
+
+void Parameters::set_numa_replicate_data(bool p_numa_replicate_data) {
+	this->numa_replicate_data = p_numa_replicate_data;
+}
+
+bool Parameters::is_dataset_cache() const {
+	return this->dataset_cache;
+}
+
+void Parameters::set_dataset_cache(bool p_dataset_cache) {
+	this->dataset_cache = p_dataset_cache;
+}
+
+int Parameters::get_dataset_block_size() const {
+	return this->dataset_block_size;
+}
+
+void Parameters::set_dataset_block_size(int p_dataset_block_size) {
+	assert(p_dataset_block_size >= 0);
+	this->dataset_block_size = p_dataset_block_size;
+}
+
+int Parameters::get_num_eval_processes() const {
+	return this->num_eval_processes;
+}
+
+void Parameters::set_num_eval_processes(int p_num_eval_processes) {
+	assert(p_num_eval_processes > 0);
+	this->num_eval_processes = p_num_eval_processes;
+}
+
+int Parameters::get_external_batch_size() const {
+	return this->external_batch_size;
+}
+
+void Parameters::set_external_batch_size(int p_external_batch_size) {
+	assert(p_external_batch_size > 0);
+	this->external_batch_size = p_external_batch_size;
+}
+
+int Parameters::get_external_batches_in_flight() const {
+	return this->external_batches_in_flight;
+}
+
+void Parameters::set_external_batches_in_flight(
+		int p_external_batches_in_flight) {
+	assert(p_external_batches_in_flight > 0);
+	this->external_batches_in_flight = p_external_batches_in_flight;
+}
+
+const std::string& Parameters::get_external_evaluator() const {
+	return this->external_evaluator;
+}
+
+void Parameters::set_external_evaluator(
+		const std::string &p_external_evaluator) {
+	this->external_evaluator = p_external_evaluator;
+}
+
+const std::string& Parameters::get_metrics_socket() const {
+	return this->metrics_socket;
+}
+
+void Parameters::set_metrics_socket(const std::string &p_metrics_socket) {
+	this->metrics_socket = p_metrics_socket;
+}
+
+/// @brief Returns whether the fitness is computed by an external evaluator.
+/// @return true if an evaluator command has been set
+bool Parameters::is_external_evaluation() const {
+	return !this->external_evaluator.empty();
+}
+
 void Parameters::set_num_eval_threads(int p_num_eval_threads) {
 	assert(p_num_eval_threads > 0);
 	this->num_eval_threads = p_num_eval_threads;
@@ -456,6 +590,14 @@ void Parameters::set_write_statfile(bool p_write_stat_file) {
 	this->write_statfile = p_write_stat_file;
 }
 
+bool Parameters::is_write_tracefile() const {
+	return this->write_tracefile;
+}
+
+void Parameters::set_write_tracefile(bool p_write_tracefile) {
+	this->write_tracefile = p_write_tracefile;
+}
+
 void Parameters::set_mutation_operators(
 		const std::shared_ptr<std::vector<MUTATION_TYPE> > &p_mutations_operators) {
 	this->mutation_operators = p_mutations_operators;
@@ -490,6 +632,23 @@ void Parameters::set_checkpoint_modulo(int p_checkpoint_modulo) {
 	this->checkpoint_modulo = p_checkpoint_modulo;
 }
 
+CHECKPOINT_FORMAT Parameters::get_checkpoint_format() const {
+	return this->checkpoint_format;
+}
+
+void Parameters::set_checkpoint_format(CHECKPOINT_FORMAT p_checkpoint_format) {
+	assert(p_checkpoint_format == BINARY_CHECKPOINT || p_checkpoint_format == TEXT_CHECKPOINT);
+	this->checkpoint_format = p_checkpoint_format;
+}
+
+bool Parameters::is_checkpoint_delta_encoding() const {
+	return this->checkpoint_delta_encoding;
+}
+
+void Parameters::set_checkpoint_delta_encoding(bool p_checkpoint_delta_encoding) {
+	this->checkpoint_delta_encoding = p_checkpoint_delta_encoding;
+}
+
 void Parameters::set_max_duplication_depth(int p_max_duplication_depth) {
 	assert(p_max_duplication_depth > 0);
 	this->max_duplication_depth = p_max_duplication_depth;
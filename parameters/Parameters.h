@@ -18,6 +18,7 @@ typedef unsigned int MUTATION_TYPE;
 typedef unsigned int CROSSOVER_TYPE;
 typedef unsigned int ALGORITHM;
 typedef unsigned int PROBLEM;
+typedef unsigned int CHECKPOINT_FORMAT;
 
 #include <stdexcept>
 #include <iostream>
@@ -25,6 +26,7 @@ typedef unsigned int PROBLEM;
 #include <climits>
 #include <memory>
 #include <vector>
+#include <string>
 
 #include "../template/template_types.h"
 #include "../constants/erc_types.h"
@@ -47,13 +49,20 @@ public:
 
 	const ALGORITHM ONE_PLUS_LAMBDA = 0;
 	const ALGORITHM MU_PLUS_LAMBDA = 1;
+	const ALGORITHM ASYNC_STEADY_STATE = 2;
 
 	const PROBLEM SYMBOLIC_REGRESSION = 0;
 	const PROBLEM LOGIC_SYNTHESIS = 1;
 
+	const CHECKPOINT_FORMAT BINARY_CHECKPOINT = 0;
+	const CHECKPOINT_FORMAT TEXT_CHECKPOINT = 1;
+
 	const std::string STAT_FILE_DIR = "data/statfiles/";
+	const std::string TRACE_FILE_DIR = "data/tracefiles/";
 	const std::string CHECKPOINT_FILE_DIR = "data/checkpoints/";
 
+	const int FITNESS_CASE_SHARD_SIZE = 1024;
+
 private:
 
 	int genome_size;
@@ -67,6 +76,16 @@ private:
 	ERC_TYPE erc_type;
 
 	int num_jobs;
+	int num_job_threads;
+	bool pin_eval_threads;
+	bool numa_replicate_data;
+	bool dataset_cache;
+	int dataset_block_size;
+	int num_eval_processes;
+	int external_batch_size;
+	int external_batches_in_flight;
+	std::string external_evaluator;
+	std::string metrics_socket;
 	int num_eval_threads;
 	int eval_chunk_size;
 
@@ -104,19 +123,25 @@ private:
 	int num_parents;
 
 	bool neutral_genetic_drift;
+	bool pipelined_evaluation;
 
 	bool evaluate_expression;
 	bool minimizing_fitness;
 	bool report_during_job;
 	bool report_after_job;
 	bool report_simple;
+	bool phase_timing;
+	bool perf_counters;
 	bool print_configuration;
 	bool generate_random_seed;
 	bool write_statfile;
+	bool write_tracefile;
 	bool checkpointing;
 
 	int report_interval;
 	int checkpoint_modulo;
+	CHECKPOINT_FORMAT checkpoint_format;
+	bool checkpoint_delta_encoding;
 	int simple_report_type;
 
 public:
@@ -203,6 +228,29 @@ public:
 	int get_num_jobs() const;
 	void set_num_jobs(int p_num_jobs);
 
+	int get_num_job_threads() const;
+	void set_num_job_threads(int p_num_job_threads);
+	bool is_pin_eval_threads() const;
+	void set_pin_eval_threads(bool p_pin_eval_threads);
+	bool is_numa_replicate_data() const;
+	void set_numa_replicate_data(bool p_numa_replicate_data);
+	bool is_dataset_cache() const;
+	void set_dataset_cache(bool p_dataset_cache);
+	int get_dataset_block_size() const;
+	void set_dataset_block_size(int p_dataset_block_size);
+	int get_num_eval_processes() const;
+	void set_num_eval_processes(int p_num_eval_processes);
+	int get_external_batch_size() const;
+	void set_external_batch_size(int p_external_batch_size);
+	int get_external_batches_in_flight() const;
+	void set_external_batches_in_flight(int p_external_batches_in_flight);
+	const std::string& get_external_evaluator() const;
+	void set_external_evaluator(const std::string &p_external_evaluator);
+
+	const std::string& get_metrics_socket() const;
+	void set_metrics_socket(const std::string &p_metrics_socket);
+	bool is_external_evaluation() const;
+
 	int get_num_eval_threads() const;
 	void set_num_eval_threads(int p_num_eval_threads);
 
@@ -218,6 +266,12 @@ public:
 	bool is_report_simple() const;
 	void set_report_simple(bool p_report_simple);
 
+	bool is_phase_timing() const;
+	void set_phase_timing(bool p_phase_timing);
+
+	bool is_perf_counters() const;
+	void set_perf_counters(bool p_perf_counters);
+
 	int get_simple_report_type() const;
 	void set_simple_report_type(int p_simple_report_type);
 
@@ -226,6 +280,8 @@ public:
 
 	bool is_neutral_genetic_drift() const;
 	void set_neutral_genetic_drift(bool p_neutral_genetic_drift);
+	bool is_pipelined_evaluation() const;
+	void set_pipelined_evaluation(bool p_pipelined_evaluation);
 
 	bool is_print_configuration() const;
 	void set_print_configuration(bool p_print_parameters);
@@ -245,12 +301,21 @@ public:
 	bool is_write_statfile() const;
 	void set_write_statfile(bool p_write_output_file);
 
+	bool is_write_tracefile() const;
+	void set_write_tracefile(bool p_write_tracefile);
+
 	bool is_checkpointing() const;
 	void set_checkpointing(bool p_checkpointing);
 
 	int get_checkpoint_modulo() const;
 	void set_checkpoint_modulo(int p_checkpoint_modulo);
 
+	CHECKPOINT_FORMAT get_checkpoint_format() const;
+	void set_checkpoint_format(CHECKPOINT_FORMAT p_checkpoint_format);
+
+	bool is_checkpoint_delta_encoding() const;
+	void set_checkpoint_delta_encoding(bool p_checkpoint_delta_encoding);
+
 	float get_inversion_rate() const;
 	void set_inversion_rate(float p_inversion_rate);
 
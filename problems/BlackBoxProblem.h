@@ -16,13 +16,16 @@
 
 #include <stdexcept>
 #include <memory>
-#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <functional>
 
 #include "../parameters/Parameters.h"
 #include "../evaluator/Evaluator.h"
 #include "../representation/Individual.h"
-
-std::mutex mtx;
+#include "../concurrency/ThreadPool.h"
+#include "../benchmark/Dataset.h"
 
 /// @brief Base class to represent a black box problem.
 /// @details Provides core functionality for the evaluation of the black box problem. 
@@ -35,13 +38,15 @@ protected:
 	std::shared_ptr<Parameters> parameters;
 	std::shared_ptr<Evaluator<E, G, F>> evaluator;
 
-	std::shared_ptr<std::vector<std::vector<E>>> inputs;
-	std::shared_ptr<std::vector<std::vector<E>>> outputs;
+	std::shared_ptr<const Dataset<E>> dataset;
 
-	std::shared_ptr<std::vector<E>> constants;
+	std::shared_ptr<const std::vector<E>> constants;
 
 	std::shared_ptr<std::vector<E>> outputs_individual;
 
+	std::vector<std::shared_ptr<Evaluator<E, G, F>>> shard_evaluators;
+	std::vector<std::shared_ptr<const Dataset<E>>> shard_datasets;
+
 	std::string name;
 
 	int num_variables;
@@ -49,6 +54,11 @@ protected:
 	int num_inputs;
 	int num_outputs;
 	int num_instances;
+	int shard_size;
+
+	F evaluate_cases(std::shared_ptr<Individual<G, F>> individual, int begin,
+			int end, Evaluator<E, G, F> &p_evaluator,
+			const Dataset<E> &p_dataset);
 
 public:
 	BlackBoxProblem(std::shared_ptr<Parameters> p_parameters,
@@ -61,24 +71,43 @@ public:
 
 	BlackBoxProblem(std::shared_ptr<Parameters> p_parameters,
 			std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
-			std::shared_ptr<std::vector<std::vector<E>>> p_inputs,
-			std::shared_ptr<std::vector<std::vector<E>>> p_outputs,
-			std::shared_ptr<std::vector<E>> p_constants, int p_num_instances);
+			std::shared_ptr<Dataset<E>> p_dataset,
+			std::shared_ptr<std::vector<E>> p_constants);
 
 	BlackBoxProblem(const BlackBoxProblem &problem);
 
 	virtual void evaluate_individual(
-				std::shared_ptr<Individual<G, F>> individual);
+				std::shared_ptr<Individual<G, F>> individual,
+				const std::atomic<bool> *cancel = nullptr);
+	virtual void evaluate_individual(
+				std::shared_ptr<Individual<G, F>> individual, ThreadPool &pool,
+				const std::atomic<bool> *cancel = nullptr);
+	virtual void evaluate_batch(
+				std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+				const std::atomic<bool> *cancel,
+				const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated);
+	virtual void evaluate_batch(
+				std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+				ThreadPool &pool, const std::atomic<bool> *cancel,
+				const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated);
+	virtual bool is_batched() const;
 
 	virtual BlackBoxProblem<E, G, F>* clone() = 0;
 	virtual F evaluate(std::shared_ptr<std::vector<E>> outputs_real,
 			std::shared_ptr<std::vector<E>> outputs_individual) = 0;
 	const std::string& get_name() const;
+	const std::shared_ptr<Evaluator<E, G, F>>& get_evaluator() const;
+	int get_num_instances() const;
+	int get_num_shards() const;
+	const std::shared_ptr<const Dataset<E>>& get_dataset() const;
+	void set_data(std::shared_ptr<const Dataset<E>> p_dataset);
+	void set_worker_data(int worker,
+			std::shared_ptr<const Dataset<E>> p_dataset);
 
 	virtual ~BlackBoxProblem() = default;
 };
 
-/// @brief Constructor that instantiates the vector for the input/output mappings
+/// @brief Constructor for problems that do not hold a dataset in the process
 ///	@details Dimension of the problem is based on the number of considered instances 
 /// @param p_parameters shared pointer to parameter object
 /// @param p_evaluator shared pointer to evaluator object
@@ -106,64 +135,57 @@ BlackBoxProblem<E, G, F>::BlackBoxProblem(
 	num_outputs = parameters->get_num_outputs();
 
 	num_instances = p_num_instances;
-
-	inputs = std::make_shared<std::vector<std::vector<E>>>(num_instances);
-	outputs = std::make_shared<std::vector<std::vector<E>>>(num_instances);
+	shard_size = parameters->FITNESS_CASE_SHARD_SIZE;
 
 	outputs_individual = std::make_shared<std::vector<E>>(num_outputs);
 
 }
 
-/// @brief Overloaded constructor that initializes the input/output vectors
-/// @param p_inputs shared pointer to input data vector
-/// @param p_outputs shared pointer to output data vector
+/// @brief Overloaded constructor that initializes the problem with a dataset
 /// @param p_parameters shared pointer to parameter object
 /// @param p_evaluator shared pointer to evaluator object
+/// @param p_dataset shared pointer to the dataset of the problem
 /// @param p_constants shared pointer to constants vector
-/// @param p_num_instances number of instances considered by the problem 
 template<class E, class G, class F>
 BlackBoxProblem<E, G, F>::BlackBoxProblem(
 		std::shared_ptr<Parameters> p_parameters,
 		std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
-		std::shared_ptr<std::vector<std::vector<E>>> p_inputs,
-		std::shared_ptr<std::vector<std::vector<E>>> p_outputs,
-		std::shared_ptr<std::vector<E>> p_constants, int p_num_instances) :
+		std::shared_ptr<Dataset<E>> p_dataset,
+		std::shared_ptr<std::vector<E>> p_constants) :
 		BlackBoxProblem<E, G, F>(p_parameters, p_evaluator, p_constants,
-				p_num_instances) {
+				p_dataset != nullptr ? p_dataset->get_num_instances() : 0) {
 
-
-	if (p_inputs == nullptr || p_outputs == nullptr) {
+	if (p_dataset == nullptr) {
 		throw std::invalid_argument(
 				"Nullpointer exception in BlackBoxProblem class!");
 	}
 
-	if (p_inputs->size() == 0 || p_outputs->size() == 0) {
-		throw std::invalid_argument("Empty vector in BlackBoxProblem class!");
+	if (p_dataset->get_num_instances() == 0) {
+		throw std::invalid_argument("Empty dataset in BlackBoxProblem class!");
 	}
 
-	E value;
-
-	for (int i = 0; i < this->num_instances; i++) {
-		for (int j = 0; j < this->num_variables; j++) {
-			value = (*p_inputs)[i][j];
-			this->inputs->at(i).push_back(value);
-		}
-
-		for (int j = 0; j < this->num_outputs; j++) {
-			value = (*p_outputs)[i][j];
-			this->outputs->at(i).push_back(value);
-		}
+	// The dataset is read-only during evolution and is therefore shared
+	// with the caller instead of being copied
+	if (p_dataset->get_num_inputs() != this->num_variables
+			|| p_dataset->get_num_outputs() != this->num_outputs) {
+		throw std::invalid_argument(
+				"Dataset does not match the problem dimension!");
 	}
 
+	this->dataset = p_dataset;
 }
 
-/// @brief Copy constructor for deep cloning 
+/// @brief Copy constructor for cloning 
+/// @details The clone obtains its own evaluator since the evaluator keeps
+/// intermediate node values while evaluating an individual. The dataset and 
+/// the constants are immutable and shared with the original problem, so a 
+/// clone does not depend on the size of the dataset. 
 /// @param problem problem instance to clone
 template<class E, class G, class F>
 BlackBoxProblem<E, G, F>::BlackBoxProblem(const BlackBoxProblem &problem) {
 
 	parameters = problem.parameters;
-	evaluator = problem.evaluator;
+	evaluator = std::make_shared<Evaluator<E, G, F>>(*problem.evaluator);
 
 	num_variables = problem.num_variables;
 	num_constants = problem.num_constants;
@@ -171,11 +193,10 @@ BlackBoxProblem<E, G, F>::BlackBoxProblem(const BlackBoxProblem &problem) {
 	num_inputs = problem.num_inputs;
 	num_outputs = problem.num_outputs;
 	num_instances = problem.num_instances;
+	shard_size = problem.shard_size;
 
-	inputs = std::make_shared<std::vector<std::vector<E>>>(*problem.inputs);
-	outputs = std::make_shared<std::vector<std::vector<E>>>(*problem.outputs);
-
-	constants = std::make_shared<std::vector<E>>(*problem.constants);
+	dataset = problem.dataset;
+	constants = problem.constants;
 
 	outputs_individual = std::make_shared<std::vector<E>>(num_outputs);
 }
@@ -185,46 +206,325 @@ const std::string& BlackBoxProblem<E, G, F>::get_name() const {
 	return this->name;
 }
 
+template<class E, class G, class F>
+const std::shared_ptr<Evaluator<E, G, F>>& BlackBoxProblem<E, G, F>::get_evaluator() const {
+	return this->evaluator;
+}
+
+template<class E, class G, class F>
+int BlackBoxProblem<E, G, F>::get_num_instances() const {
+	return this->num_instances;
+}
+
+/// @brief Returns the number of shards the fitness cases are split into.
+/// @return number of shards 
+template<class E, class G, class F>
+int BlackBoxProblem<E, G, F>::get_num_shards() const {
+	return (this->num_instances + this->shard_size - 1) / this->shard_size;
+}
+
+template<class E, class G, class F>
+const std::shared_ptr<const Dataset<E>>& BlackBoxProblem<E, G, F>::get_dataset() const {
+	return this->dataset;
+}
+
+/// @brief Replaces the dataset of the problem by an equal copy.
+/// @details Used to let a problem clone work on a replica of the dataset that 
+/// resides on the NUMA node of the evaluating thread.
+/// @param p_dataset shared pointer to the dataset
+template<class E, class G, class F>
+void BlackBoxProblem<E, G, F>::set_data(
+		std::shared_ptr<const Dataset<E>> p_dataset) {
+
+	if (p_dataset == nullptr) {
+		throw std::invalid_argument(
+				"Nullpointer exception in BlackBoxProblem class!");
+	}
+
+	if (p_dataset->get_num_instances() != this->num_instances) {
+		throw std::invalid_argument(
+				"Dataset does not match the problem dimension!");
+	}
+
+	this->dataset = p_dataset;
+}
+
+/// @brief Sets the dataset replica that is used by a pool worker for the 
+/// evaluation of shards.
+/// @details Workers without a replica use the dataset of the problem.
+/// @param worker index of the pool worker
+/// @param p_dataset shared pointer to the dataset replica
+template<class E, class G, class F>
+void BlackBoxProblem<E, G, F>::set_worker_data(int worker,
+		std::shared_ptr<const Dataset<E>> p_dataset) {
+
+	if (p_dataset == nullptr) {
+		throw std::invalid_argument(
+				"Nullpointer exception in BlackBoxProblem class!");
+	}
+
+	if (p_dataset->get_num_instances() != this->num_instances) {
+		throw std::invalid_argument(
+				"Dataset does not match the problem dimension!");
+	}
+
+	if ((int) this->shard_datasets.size() <= worker) {
+		this->shard_datasets.resize(worker + 1);
+	}
+
+	this->shard_datasets.at(worker) = p_dataset;
+}
+
+
+/// @brief Evaluates a range of fitness cases with the passed evaluator.
+/// @details The scratch vectors for the inputs and outputs are allocated once 
+/// per range and reused for each case. The values of a case are gathered from 
+/// the columns of the dataset.
+/// @param individual decoded individual to evaluate
+/// @param begin first fitness case
+/// @param end fitness case after the last one of the range
+/// @param p_evaluator evaluator that is used for the range
+/// @param p_dataset dataset the range refers to
+/// @return partial error of the range
+template<class E, class G, class F>
+F BlackBoxProblem<E, G, F>::evaluate_cases(
+		std::shared_ptr<Individual<G, F>> individual, int begin, int end,
+		Evaluator<E, G, F> &p_evaluator, const Dataset<E> &p_dataset) {
+
+	PerfCounters::Scope perf_scope(p_evaluator.get_perf_counters(),
+			PerfCounters::EVALUATE);
+	AllocCounters::Scope alloc_scope(p_evaluator.get_alloc_counters(),
+			AllocCounters::EVALUATE);
+
+	F diff = 0;
+
+	std::shared_ptr<std::vector<E>> input_instance = std::make_shared<
+			std::vector<E>>(this->num_variables);
+	std::shared_ptr<std::vector<E>> output_instace = std::make_shared<
+			std::vector<E>>(this->num_outputs);
+	std::shared_ptr<std::vector<E>> outputs_ind = std::make_shared<
+			std::vector<E>>();
+
+	if (this->num_constants > 0) {
+		input_instance->insert(std::end(*input_instance),
+				std::begin(*constants), std::end(*constants));
+	}
+
+	for (int i = begin; i < end; i++) {
+		for (int j = 0; j < this->num_variables; j++) {
+			(*input_instance)[j] = p_dataset.input_column(j)[i];
+		}
+
+		for (int j = 0; j < this->num_outputs; j++) {
+			(*output_instace)[j] = p_dataset.output_column(j)[i];
+		}
+
+		outputs_ind->clear();
+
+		p_evaluator.evaluate_iterative(individual, input_instance,
+				outputs_ind);
+
+		diff += this->evaluate(output_instace, outputs_ind);
+	}
+
+#ifdef CGP_EVAL_COUNTERS
+	p_evaluator.get_counters()->count_cases(end - begin,
+			individual->get_active_nodes()->size());
+#endif
+
+	if (p_evaluator.get_perf_counters() != nullptr) {
+		p_evaluator.get_perf_counters()->count_node_evaluations(
+				(long long) (end - begin)
+						* individual->get_active_nodes()->size());
+	}
+
+	return diff;
+}
 
 /// @brief Evaluates an individual against the given input/output matching
 /// @details Iterative evaluation procedure for each instance of the problem.
+/// The active path is decoded beforehand by the evaluator of the problem if required.
+/// The fitness cases are processed in shards whose partial errors are summed up 
+/// in shard order, which gives the same fitness as the sharded concurrent evaluation.
+/// If the passed cancellation flag is set, the evaluation stops at the next shard 
+/// boundary and the individual remains unevaluated. 
 /// @param individual individual to evaluate
+/// @param cancel optional cancellation flag
 template<class E, class G, class F>
 void BlackBoxProblem<E, G, F>::evaluate_individual(
-		std::shared_ptr<Individual<G, F>> individual) {
+		std::shared_ptr<Individual<G, F>> individual,
+		const std::atomic<bool> *cancel) {
 
 	if (individual->is_evaluated()) {
+#ifdef CGP_EVAL_COUNTERS
+		this->evaluator->get_counters()->count_evaluation_skip();
+#endif
 		return;
 	}
 
+	// Decode the active path unless the genome is unchanged since the last decoding
+	if (!individual->is_decoded()) {
+		this->evaluator->decode_path(individual);
+	}
+#ifdef CGP_EVAL_COUNTERS
+	else {
+		this->evaluator->get_counters()->count_decode_skip();
+	}
+#endif
+
 	F diff = 0;
 
-	std::shared_ptr<std::vector<E>> input_instance;
-	std::shared_ptr<std::vector<E>> output_instace;
-	std::shared_ptr<std::vector<E>> outputs_ind = std::make_shared<
-			std::vector<E>>();
+	for (int begin = 0; begin < this->num_instances; begin += this->shard_size) {
+		if (cancel != nullptr && *cancel) {
+#ifdef CGP_EVAL_COUNTERS
+			this->evaluator->get_counters()->count_cancellation();
+#endif
+			return;
+		}
+
+		int end = std::min(begin + this->shard_size, this->num_instances);
+		diff += this->evaluate_cases(individual, begin, end, *this->evaluator,
+				*this->dataset);
+	}
+
+	individual->set_fitness(diff);
+	individual->set_evaluated(true);
 
-	for (int i = 0; i < this->num_instances; i++) {
-		input_instance = std::make_shared<std::vector<E>>(this->inputs->at(i));
-		output_instace = std::make_shared<std::vector<E>>(this->outputs->at(i));
+#ifdef CGP_EVAL_COUNTERS
+	this->evaluator->get_counters()->count_individual(
+			individual->get_active_nodes()->size());
+#endif
+}
+
+/// @brief Evaluates an individual by distributing its fitness cases over a thread pool. 
+/// @details The fitness cases are split into shards of fixed size that are evaluated by 
+/// the pool workers, each with its own evaluator. The partial errors are reduced in shard 
+/// order, so the fitness does not depend on the number of workers. Workers that 
+/// have been assigned a dataset replica read the fitness cases from it. Shards that 
+/// start after the cancellation flag has been set are skipped and the individual 
+/// remains unevaluated. 
+/// @param individual individual to evaluate
+/// @param pool thread pool whose workers evaluate the shards
+/// @param cancel optional cancellation flag
+template<class E, class G, class F>
+void BlackBoxProblem<E, G, F>::evaluate_individual(
+		std::shared_ptr<Individual<G, F>> individual, ThreadPool &pool,
+		const std::atomic<bool> *cancel) {
 
-		if (this->num_constants > 0) {
-			input_instance->insert(std::end(*input_instance),
-					std::begin(*constants), std::end(*constants));
+	if (individual->is_evaluated()) {
+#ifdef CGP_EVAL_COUNTERS
+		this->evaluator->get_counters()->count_evaluation_skip();
+#endif
+		return;
+	}
+
+	if (!individual->is_decoded()) {
+		this->evaluator->decode_path(individual);
+	}
+#ifdef CGP_EVAL_COUNTERS
+	else {
+		this->evaluator->get_counters()->count_decode_skip();
+	}
+#endif
+
+	while ((int) this->shard_evaluators.size() < pool.size()) {
+		this->shard_evaluators.push_back(
+				std::make_shared<Evaluator<E, G, F>>(*this->evaluator));
+	}
+
+	int num_shards = this->get_num_shards();
+	std::vector<F> partial_diffs(num_shards);
+	std::atomic<bool> incomplete(false);
+
+	pool.run(num_shards, [&](int shard, int worker) {
+		Tracer::Span span(this->evaluator->get_tracer(), "Shard", "evaluation",
+				-1, shard);
+
+		if (cancel != nullptr && *cancel) {
+			incomplete = true;
+			return;
 		}
 
-		outputs_ind->clear();
+		bool has_replica = worker < (int) this->shard_datasets.size()
+				&& this->shard_datasets.at(worker) != nullptr;
 
-		mtx.lock();
-		this->evaluator->evaluate_iterative(individual, input_instance,
-				outputs_ind);
-		mtx.unlock();
+		const Dataset<E> &p_dataset =
+				has_replica ? *this->shard_datasets.at(worker) : *this->dataset;
 
-		diff += this->evaluate(output_instace, outputs_ind);
+		int begin = shard * this->shard_size;
+		int end = std::min(begin + this->shard_size, this->num_instances);
+		partial_diffs[shard] = this->evaluate_cases(individual, begin, end,
+				*this->shard_evaluators.at(worker), p_dataset);
+	});
+
+	if (incomplete) {
+#ifdef CGP_EVAL_COUNTERS
+		this->evaluator->get_counters()->count_cancellation();
+#endif
+		return;
+	}
+
+	F diff = 0;
+
+	for (int i = 0; i < num_shards; i++) {
+		diff += partial_diffs[i];
 	}
 
 	individual->set_fitness(diff);
 	individual->set_evaluated(true);
+
+#ifdef CGP_EVAL_COUNTERS
+	this->evaluator->get_counters()->count_individual(
+			individual->get_active_nodes()->size());
+#endif
+}
+
+/// @brief Evaluates several individuals at once. 
+/// @details Problems that evaluate outside of the process override this method to 
+/// send the individuals in batches. By default, the individuals are evaluated one 
+/// after another until the cancellation flag is set. 
+/// @param individuals individuals to evaluate
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void BlackBoxProblem<E, G, F>::evaluate_batch(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+
+	for (auto &individual : individuals) {
+		if (individual->is_evaluated()) {
+			continue;
+		}
+
+		this->evaluate_individual(individual, cancel);
+
+		if (individual->is_evaluated()) {
+			on_evaluated(individual);
+		}
+	}
+}
+
+/// @brief Evaluates several individuals at once with the workers of a thread pool.
+/// @details By default, the pool is not used and the individuals are evaluated 
+/// like without a pool. 
+/// @param individuals individuals to evaluate
+/// @param pool thread pool whose workers may share the evaluation
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void BlackBoxProblem<E, G, F>::evaluate_batch(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		ThreadPool &pool, const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+	this->evaluate_batch(individuals, cancel, on_evaluated);
+}
+
+/// @brief Returns whether the problem prefers to evaluate individuals in batches.
+/// @return true if batches should be passed to evaluate_batch
+template<class E, class G, class F>
+bool BlackBoxProblem<E, G, F>::is_batched() const {
+	return false;
 }
 
 #endif /* PROBLEMS_BLACKBOXPROBLEM_H_ */
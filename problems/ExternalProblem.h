@@ -0,0 +1,557 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: ExternalProblem.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROBLEMS_EXTERNALPROBLEM_H_
+#define PROBLEMS_EXTERNALPROBLEM_H_
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <functional>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "BlackBoxProblem.h"
+#include "../functions/Functions.h"
+
+/// @brief Black box problem whose fitness is computed by an external evaluator process.
+/// @details The evaluator is started with the configured shell command on the first
+/// evaluation and communicates over a Unix domain socket that is connected to its
+/// standard input and output. Individuals are decoded and sent in batches of compact
+/// phenotypes: only the active nodes are transmitted, each with its function and the
+/// connections required by the arity of the function. Connections are renumbered so
+/// that input k is referred to by k and the i-th active node by num_inputs + i.
+/// Several batches are kept in flight to hide the latency of the evaluator.
+///
+/// All integers are unsigned 32-bit values in host byte order, functions are
+/// 16-bit values. Each message starts with the header (type, id, count, payload size):
+/// - HELLO (main -> evaluator): version, number of inputs, number of variables,
+///   number of outputs, number of functions and size of a value, followed by the
+///   arity (8-bit), name length (16-bit) and name of each function and by the values
+///   of the constants. The inputs are the variables followed by the constants, so
+///   input k refers to constant k - number of variables if k is not a variable.
+///   The evaluator answers with a HELLO without payload.
+/// - BATCH (main -> evaluator): count programs, each consisting of the number of
+///   active nodes, the nodes (function, connections) and the output connections.
+/// - RESULTS (evaluator -> main): count fitness values as doubles for the batch id.
+/// - SHUTDOWN (main -> evaluator): no payload, the evaluator terminates.
+/// @tparam E Evalation type
+/// @tparam G Genome type
+/// @tparam F Fitness type
+template<class E, class G, class F>
+class ExternalProblem: public BlackBoxProblem<E, G, F> {
+private:
+	static constexpr uint32_t PROTOCOL_VERSION = 2;
+
+	enum MessageType : uint32_t {
+		HELLO = 1, BATCH = 2, RESULTS = 3, SHUTDOWN = 4
+	};
+
+	/// @brief Header of each message.
+	struct Header {
+		uint32_t type;
+		uint32_t id;
+		uint32_t count;
+		uint32_t payload_size;
+	};
+
+	/// @brief Batch that has been sent and awaits its results.
+	struct Batch {
+		uint32_t id;
+		int begin;
+		int end;
+	};
+
+	std::shared_ptr<Functions<E>> functions;
+	std::string command;
+
+	int batch_size;
+	int batches_in_flight;
+	int num_functions;
+
+	int socket_fd;
+	pid_t pid;
+	uint32_t next_batch_id;
+
+	void connect();
+	void disconnect();
+	void send_message(uint32_t type, uint32_t id, uint32_t count,
+			const std::vector<char> &payload);
+	Header receive_header();
+	void write_all(const void *data, std::size_t size);
+	void read_all(void *data, std::size_t size);
+
+	void encode(std::shared_ptr<Individual<G, F>> individual,
+			std::vector<char> &buffer);
+	int connection(std::shared_ptr<Individual<G, F>> individual, int position);
+
+	template<class T>
+	static void put(std::vector<char> &buffer, T value);
+
+public:
+	ExternalProblem(std::shared_ptr<Parameters> p_parameters,
+			std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
+			std::shared_ptr<Functions<E>> p_functions,
+			std::shared_ptr<std::vector<E>> p_constants,
+			const std::string &p_command);
+	ExternalProblem(const ExternalProblem &problem);
+	~ExternalProblem();
+
+	void evaluate_individual(std::shared_ptr<Individual<G, F>> individual,
+			const std::atomic<bool> *cancel = nullptr) override;
+	void evaluate_individual(std::shared_ptr<Individual<G, F>> individual,
+			ThreadPool &pool, const std::atomic<bool> *cancel = nullptr)
+					override;
+	void evaluate_batch(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+			const std::atomic<bool> *cancel,
+			const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated)
+					override;
+	void evaluate_batch(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+			ThreadPool &pool, const std::atomic<bool> *cancel,
+			const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated)
+					override;
+	bool is_batched() const override;
+
+	F evaluate(std::shared_ptr<std::vector<E>> outputs_real,
+			std::shared_ptr<std::vector<E>> outputs_individual) override;
+	ExternalProblem<E, G, F>* clone() override;
+};
+
+/// @brief Constructor of the external problem.
+/// @details The problem holds no dataset since the fitness cases are known to the
+/// external evaluator only. The evaluator process is started lazily.
+/// @param p_parameters shared pointer to parameter object
+/// @param p_evaluator shared pointer to evaluator object used for decoding
+/// @param p_functions shared pointer to the function set
+/// @param p_constants shared pointer to constants vector
+/// @param p_command shell command that starts the external evaluator
+template<class E, class G, class F>
+ExternalProblem<E, G, F>::ExternalProblem(
+		std::shared_ptr<Parameters> p_parameters,
+		std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
+		std::shared_ptr<Functions<E>> p_functions,
+		std::shared_ptr<std::vector<E>> p_constants,
+		const std::string &p_command) :
+		BlackBoxProblem<E, G, F>(p_parameters, p_evaluator, p_constants, 0) {
+
+	if (p_functions == nullptr) {
+		throw std::invalid_argument(
+				"Nullpointer exception in ExternalProblem class!");
+	}
+
+	if (p_command.empty()) {
+		throw std::invalid_argument(
+				"Empty evaluator command in ExternalProblem class!");
+	}
+
+	this->name = "External Problem";
+
+	functions = p_functions;
+	command = p_command;
+
+	batch_size = this->parameters->get_external_batch_size();
+	batches_in_flight = this->parameters->get_external_batches_in_flight();
+	num_functions = this->parameters->get_num_functions();
+
+	socket_fd = -1;
+	pid = -1;
+	next_batch_id = 0;
+}
+
+/// @brief Copy constructor for deep cloning.
+/// @details The clone starts its own evaluator process when it is used.
+/// @param problem problem instance to clone
+template<class E, class G, class F>
+ExternalProblem<E, G, F>::ExternalProblem(const ExternalProblem &problem) :
+		BlackBoxProblem<E, G, F>(problem) {
+	this->name = problem.name;
+
+	functions = problem.functions;
+	command = problem.command;
+
+	batch_size = problem.batch_size;
+	batches_in_flight = problem.batches_in_flight;
+	num_functions = problem.num_functions;
+
+	socket_fd = -1;
+	pid = -1;
+	next_batch_id = 0;
+}
+
+/// @brief Destructor that shuts the evaluator process down.
+template<class E, class G, class F>
+ExternalProblem<E, G, F>::~ExternalProblem() {
+	this->disconnect();
+}
+
+/// @brief Starts the evaluator process and performs the handshake.
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::connect() {
+
+	int fds[2];
+
+	if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+		throw std::runtime_error("Could not create the evaluator socket!");
+	}
+
+	pid = fork();
+
+	if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		throw std::runtime_error("Could not start the external evaluator!");
+	}
+
+	if (pid == 0) {
+		dup2(fds[1], STDIN_FILENO);
+		dup2(fds[1], STDOUT_FILENO);
+		execl("/bin/sh", "sh", "-c", command.c_str(), (char*) nullptr);
+		_exit(127);
+	}
+
+	close(fds[1]);
+	socket_fd = fds[0];
+
+	std::vector<char> payload;
+	put<uint32_t>(payload, PROTOCOL_VERSION);
+	put<uint32_t>(payload, this->num_inputs);
+	put<uint32_t>(payload, this->num_variables);
+	put<uint32_t>(payload, this->num_outputs);
+	put<uint32_t>(payload, this->num_functions);
+	put<uint32_t>(payload, sizeof(E));
+
+	for (int i = 0; i < this->num_functions; i++) {
+		std::string name = this->functions->function_name(i);
+		put<uint8_t>(payload, this->functions->arity_of(i));
+		put<uint16_t>(payload, name.size());
+		payload.insert(payload.end(), name.begin(), name.end());
+	}
+
+	for (int i = 0; i < this->num_inputs - this->num_variables; i++) {
+		put<E>(payload, this->constants->at(i));
+	}
+
+	this->send_message(HELLO, 0, 0, payload);
+
+	Header header = this->receive_header();
+
+	if (header.type != HELLO || header.payload_size != 0) {
+		throw std::runtime_error("Invalid handshake of the external evaluator!");
+	}
+}
+
+/// @brief Sends the shutdown message and waits for the evaluator process.
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::disconnect() {
+
+	if (socket_fd < 0) {
+		return;
+	}
+
+	// The evaluator may already be gone, so errors are ignored here
+	Header header { SHUTDOWN, 0, 0, 0 };
+	send(socket_fd, &header, sizeof(Header), MSG_NOSIGNAL);
+
+	close(socket_fd);
+	socket_fd = -1;
+
+	waitpid(pid, nullptr, 0);
+	pid = -1;
+}
+
+/// @brief Appends a value in host byte order to a buffer.
+/// @param buffer message buffer
+/// @param value value to append
+template<class E, class G, class F>
+template<class T>
+void ExternalProblem<E, G, F>::put(std::vector<char> &buffer, T value) {
+	const char *bytes = reinterpret_cast<const char*>(&value);
+	buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::write_all(const void *data, std::size_t size) {
+	const char *bytes = static_cast<const char*>(data);
+
+	while (size > 0) {
+		ssize_t written = send(socket_fd, bytes, size, MSG_NOSIGNAL);
+
+		if (written <= 0) {
+			if (written < 0 && errno == EINTR) {
+				continue;
+			}
+			throw std::runtime_error("External evaluator has terminated!");
+		}
+
+		bytes += written;
+		size -= written;
+	}
+}
+
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::read_all(void *data, std::size_t size) {
+	char *bytes = static_cast<char*>(data);
+
+	while (size > 0) {
+		ssize_t received = recv(socket_fd, bytes, size, 0);
+
+		if (received <= 0) {
+			if (received < 0 && errno == EINTR) {
+				continue;
+			}
+			throw std::runtime_error("External evaluator has terminated!");
+		}
+
+		bytes += received;
+		size -= received;
+	}
+}
+
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::send_message(uint32_t type, uint32_t id,
+		uint32_t count, const std::vector<char> &payload) {
+	Header header { type, id, count, (uint32_t) payload.size() };
+	this->write_all(&header, sizeof(Header));
+	this->write_all(payload.data(), payload.size());
+}
+
+template<class E, class G, class F>
+typename ExternalProblem<E, G, F>::Header ExternalProblem<E, G, F>::receive_header() {
+	Header header;
+	this->read_all(&header, sizeof(Header));
+	return header;
+}
+
+/// @brief Returns the connection gene at a position of the genome.
+/// @param individual decoded individual
+/// @param position position in the genome
+/// @return node number or input the gene refers to
+template<class E, class G, class F>
+int ExternalProblem<E, G, F>::connection(
+		std::shared_ptr<Individual<G, F>> individual, int position) {
+	G gene = individual->get_genome()[position];
+
+	if (individual->is_real_valued()) {
+		return individual->interpret_float(gene, position);
+	}
+
+	return gene;
+}
+
+/// @brief Appends the phenotype of a decoded individual to a buffer.
+/// @param individual decoded individual
+/// @param buffer message buffer
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::encode(
+		std::shared_ptr<Individual<G, F>> individual,
+		std::vector<char> &buffer) {
+
+	const std::vector<int> &active_nodes = *individual->get_active_nodes();
+
+	// Renumber the active nodes in the order of evaluation
+	std::map<int, uint32_t> index;
+	for (int i = 0; i < (int) active_nodes.size(); i++) {
+		index[active_nodes.at(i)] = this->num_inputs + i;
+	}
+
+	auto reference = [&](int node) -> uint32_t {
+		if (node < this->num_inputs) {
+			return node;
+		}
+		return index.at(node);
+	};
+
+	put<uint32_t>(buffer, active_nodes.size());
+
+	for (int node : active_nodes) {
+		int position = individual->position_from_node_number(node);
+		int function = this->connection(individual, position);
+
+		put<uint16_t>(buffer, function);
+
+		for (int i = 0; i < this->functions->arity_of(function); i++) {
+			put<uint32_t>(buffer,
+					reference(this->connection(individual, position + i + 1)));
+		}
+	}
+
+	int genome_size = this->parameters->get_genome_size();
+
+	for (int i = 0; i < this->num_outputs; i++) {
+		put<uint32_t>(buffer,
+				reference(this->connection(individual, genome_size - i - 1)));
+	}
+}
+
+/// @brief Evaluates a batch of individuals with the external evaluator.
+/// @details The individuals are decoded if required and sent in batches. Up to the
+/// configured number of batches are in flight before the results of the oldest batch
+/// are awaited. Once the cancellation flag is set, no further batches are sent and
+/// the remaining individuals stay unevaluated.
+/// @param individuals individuals to evaluate
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::evaluate_batch(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+
+	std::vector<std::shared_ptr<Individual<G, F>>> pending;
+
+	for (auto &individual : individuals) {
+		if (!individual->is_evaluated()) {
+			pending.push_back(individual);
+		}
+	}
+
+	if (pending.empty()) {
+		return;
+	}
+
+	if (socket_fd < 0) {
+		this->connect();
+	}
+
+	std::deque<Batch> in_flight;
+	std::vector<char> payload;
+	std::vector<double> fitness;
+
+	int next = 0;
+	int num_pending = pending.size();
+
+	while (next < num_pending || !in_flight.empty()) {
+
+		while (next < num_pending
+				&& (int) in_flight.size() < this->batches_in_flight
+				&& !(cancel != nullptr && *cancel)) {
+
+			int end = std::min(next + this->batch_size, num_pending);
+
+			payload.clear();
+			for (int i = next; i < end; i++) {
+				if (!pending.at(i)->is_decoded()) {
+					this->evaluator->decode_path(pending.at(i));
+				}
+				this->encode(pending.at(i), payload);
+			}
+
+			Batch batch { this->next_batch_id++, next, end };
+			this->send_message(BATCH, batch.id, end - next, payload);
+
+			in_flight.push_back(batch);
+			next = end;
+		}
+
+		if (cancel != nullptr && *cancel) {
+			next = num_pending;
+		}
+
+		if (in_flight.empty()) {
+			break;
+		}
+
+		Batch batch = in_flight.front();
+		in_flight.pop_front();
+
+		Header header = this->receive_header();
+		uint32_t count = batch.end - batch.begin;
+
+		if (header.type != RESULTS || header.id != batch.id
+				|| header.count != count
+				|| header.payload_size != count * sizeof(double)) {
+			throw std::runtime_error(
+					"Invalid results from the external evaluator!");
+		}
+
+		fitness.resize(count);
+		this->read_all(fitness.data(), header.payload_size);
+
+		for (int i = batch.begin; i < batch.end; i++) {
+			std::shared_ptr<Individual<G, F>> individual = pending.at(i);
+			individual->set_fitness(static_cast<F>(fitness.at(i - batch.begin)));
+			individual->set_evaluated(true);
+			on_evaluated(individual);
+		}
+	}
+}
+
+/// @brief Evaluates a single individual with the external evaluator.
+/// @param individual individual to evaluate
+/// @param cancel optional cancellation flag
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::evaluate_individual(
+		std::shared_ptr<Individual<G, F>> individual,
+		const std::atomic<bool> *cancel) {
+	std::vector<std::shared_ptr<Individual<G, F>>> individuals { individual };
+	this->evaluate_batch(individuals, cancel,
+			[](std::shared_ptr<Individual<G, F>>) {
+			});
+}
+
+/// @brief Evaluates a single individual with the external evaluator.
+/// @details The fitness cases are not known to the main process and can therefore
+/// not be distributed over the pool.
+/// @param individual individual to evaluate
+/// @param pool unused thread pool
+/// @param cancel optional cancellation flag
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::evaluate_individual(
+		std::shared_ptr<Individual<G, F>> individual, ThreadPool &pool,
+		const std::atomic<bool> *cancel) {
+	this->evaluate_individual(individual, cancel);
+}
+
+/// @brief Evaluates several individuals with the external evaluator.
+/// @details The batches are sent by the calling thread, the pool is not used.
+/// @param individuals individuals to evaluate
+/// @param pool unused thread pool
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void ExternalProblem<E, G, F>::evaluate_batch(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		ThreadPool &pool, const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+	this->evaluate_batch(individuals, cancel, on_evaluated);
+}
+
+template<class E, class G, class F>
+bool ExternalProblem<E, G, F>::is_batched() const {
+	return true;
+}
+
+/// @brief Output comparison is done by the external evaluator.
+template<class E, class G, class F>
+F ExternalProblem<E, G, F>::evaluate(
+		std::shared_ptr<std::vector<E>> outputs_real,
+		std::shared_ptr<std::vector<E>> outputs_individual) {
+	throw std::logic_error(
+			"Outputs are compared by the external evaluator!");
+}
+
+template<class E, class G, class F>
+ExternalProblem<E, G, F>* ExternalProblem<E, G, F>::clone() {
+	return new ExternalProblem<E, G, F>(*this);
+}
+
+#endif /* PROBLEMS_EXTERNALPROBLEM_H_ */
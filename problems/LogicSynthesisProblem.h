@@ -36,10 +36,8 @@ private:
 public:
 	LogicSynthesisProblem(std::shared_ptr<Parameters> p_parameters,
 			std::shared_ptr<Evaluator<E,G,F>> p_evalutor,
-			std::shared_ptr<std::vector<std::vector<E>>> p_inputs,
-			std::shared_ptr<std::vector<std::vector<E>>> p_outputs,
-			std::shared_ptr<std::vector<E>> p_constants,
-			int p_num_instances);
+			std::shared_ptr<Dataset<E>> p_dataset,
+			std::shared_ptr<std::vector<E>> p_constants);
 
 	~LogicSynthesisProblem() = default;
 
@@ -55,11 +53,9 @@ public:
 template<class E, class G, class F>
 LogicSynthesisProblem<E, G, F>::LogicSynthesisProblem(std::shared_ptr<Parameters> p_parameters,
 		std::shared_ptr<Evaluator<E,G,F>> p_evaluator,
-		std::shared_ptr<std::vector<std::vector<E>>> p_inputs,
-		std::shared_ptr<std::vector<std::vector<E>>> p_outputs,
-		std::shared_ptr<std::vector<E>> p_constants,
-		int p_num_instances) :
-		BlackBoxProblem<E, G, F>(p_parameters, p_evaluator,  p_inputs,  p_outputs , p_constants, p_num_instances) {
+		std::shared_ptr<Dataset<E>> p_dataset,
+		std::shared_ptr<std::vector<E>> p_constants) :
+		BlackBoxProblem<E, G, F>(p_parameters, p_evaluator, p_dataset, p_constants) {
 
 	this->name = "Logic Synthesis Problem";
 	this->num_bits = std::pow(2, this->num_inputs);
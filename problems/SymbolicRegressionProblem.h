@@ -14,27 +14,58 @@
 #define PROBLEMS_SYMBOLICREGRESSIONPROBLEM_H_
 
 #include "../problems/BlackBoxProblem.h"
+#include "../benchmark/DatasetStream.h"
 
 #include <cmath>
 
 /// @brief Class to represent of a sybolic regression problem.
 /// @details Absolute difference is used fitness calculation.
+/// The dataset is either held in memory or streamed from disk in blocks.
 /// @tparam E Evalation type 
 /// @tparam G Genome type 
 /// @tparam F Fitness type
 template<class E, class G, class F>
 class SymbolicRegressionProblem: public BlackBoxProblem<E, G, F> {
 private:
+	std::shared_ptr<DatasetStream<E>> stream;
+
+	void evaluate_stream(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+			ThreadPool *pool, const std::atomic<bool> *cancel,
+			const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated);
 
 public:
 	SymbolicRegressionProblem(std::shared_ptr<Parameters> p_parameters,
 			std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
-			std::shared_ptr<std::vector<std::vector<E>>> p_inputs,
-			std::shared_ptr<std::vector<std::vector<E>>> p_outputs,
-			std::shared_ptr<std::vector<E>> p_constants, int p_num_instances);
+			std::shared_ptr<Dataset<E>> p_dataset,
+			std::shared_ptr<std::vector<E>> p_constants);
+
+	SymbolicRegressionProblem(std::shared_ptr<Parameters> p_parameters,
+			std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
+			std::shared_ptr<DatasetStream<E>> p_stream,
+			std::shared_ptr<std::vector<E>> p_constants);
+
+	SymbolicRegressionProblem(const SymbolicRegressionProblem &problem);
 
 	~SymbolicRegressionProblem() = default;
 
+	void evaluate_individual(std::shared_ptr<Individual<G, F>> individual,
+			const std::atomic<bool> *cancel = nullptr) override;
+	void evaluate_individual(std::shared_ptr<Individual<G, F>> individual,
+			ThreadPool &pool, const std::atomic<bool> *cancel = nullptr)
+					override;
+	void evaluate_batch(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+			const std::atomic<bool> *cancel,
+			const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated)
+					override;
+	void evaluate_batch(
+			std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+			ThreadPool &pool, const std::atomic<bool> *cancel,
+			const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated)
+					override;
+	bool is_batched() const override;
+
 	SymbolicRegressionProblem<E, G, F>* clone() override;
 	F evaluate(std::shared_ptr<std::vector<E>> outputs_real,
 			std::shared_ptr<std::vector<E>> outputs_individual) override;
@@ -44,14 +75,266 @@ template<class E, class G, class F>
 SymbolicRegressionProblem<E, G, F>::SymbolicRegressionProblem(
 		std::shared_ptr<Parameters> p_parameters,
 		std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
-		std::shared_ptr<std::vector<std::vector<E>>> p_inputs,
-		std::shared_ptr<std::vector<std::vector<E>>> p_outputs,
-		std::shared_ptr<std::vector<E>> p_constants, int p_num_instances) :
-		BlackBoxProblem<E, G, F>(p_parameters, p_evaluator, p_inputs, p_outputs,
-				p_constants, p_num_instances) {
+		std::shared_ptr<Dataset<E>> p_dataset,
+		std::shared_ptr<std::vector<E>> p_constants) :
+		BlackBoxProblem<E, G, F>(p_parameters, p_evaluator, p_dataset,
+				p_constants) {
+
+	this->name = "Symbolic Regression Problem";
+
+}
+
+/// @brief Constructor for a dataset that is streamed from disk. 
+/// @details The block size of the stream must be a multiple of the fitness case
+/// shard size, so the fitness equals the one of the in-memory evaluation.
+/// @param p_parameters shared pointer to parameter object
+/// @param p_evaluator shared pointer to evaluator object
+/// @param p_stream shared pointer to the dataset stream
+/// @param p_constants shared pointer to constants vector
+template<class E, class G, class F>
+SymbolicRegressionProblem<E, G, F>::SymbolicRegressionProblem(
+		std::shared_ptr<Parameters> p_parameters,
+		std::shared_ptr<Evaluator<E, G, F>> p_evaluator,
+		std::shared_ptr<DatasetStream<E>> p_stream,
+		std::shared_ptr<std::vector<E>> p_constants) :
+		BlackBoxProblem<E, G, F>(p_parameters, p_evaluator, p_constants,
+				p_stream != nullptr ? p_stream->get_num_instances() : 0) {
+
+	if (p_stream == nullptr) {
+		throw std::invalid_argument(
+				"Nullpointer exception in SymbolicRegressionProblem class!");
+	}
+
+	if (p_stream->get_num_inputs() != this->num_variables
+			|| p_stream->get_num_outputs() != this->num_outputs) {
+		throw std::invalid_argument(
+				"Dataset does not match the problem dimension!");
+	}
+
+	if (p_stream->get_block_size() % this->shard_size != 0
+			&& p_stream->get_num_blocks() > 1) {
+		throw std::invalid_argument(
+				"Block size is not a multiple of the shard size!");
+	}
 
 	this->name = "Symbolic Regression Problem";
+	this->stream = p_stream;
+}
+
+/// @brief Copy constructor for cloning 
+/// @details A clone of a streaming problem reads the dataset with its own stream.
+/// @param problem problem instance to clone
+template<class E, class G, class F>
+SymbolicRegressionProblem<E, G, F>::SymbolicRegressionProblem(
+		const SymbolicRegressionProblem &problem) :
+		BlackBoxProblem<E, G, F>(problem) {
+
+	this->name = problem.name;
+
+	if (problem.stream != nullptr) {
+		this->stream = std::make_shared<DatasetStream<E>>(*problem.stream);
+	}
+}
+
+/// @brief Evaluates an individual in memory or with a pass over the streamed dataset.
+/// @param individual individual to evaluate
+/// @param cancel optional cancellation flag
+template<class E, class G, class F>
+void SymbolicRegressionProblem<E, G, F>::evaluate_individual(
+		std::shared_ptr<Individual<G, F>> individual,
+		const std::atomic<bool> *cancel) {
+
+	if (this->stream == nullptr) {
+		BlackBoxProblem<E, G, F>::evaluate_individual(individual, cancel);
+		return;
+	}
+
+	std::vector<std::shared_ptr<Individual<G, F>>> individuals { individual };
+	this->evaluate_stream(individuals, nullptr, cancel,
+			[](std::shared_ptr<Individual<G, F>>) {
+			});
+}
 
+/// @brief Evaluates an individual with the pool workers or, if the dataset is 
+/// streamed, with a pass over the dataset.
+/// @param individual individual to evaluate
+/// @param pool thread pool whose workers evaluate the shards
+/// @param cancel optional cancellation flag
+template<class E, class G, class F>
+void SymbolicRegressionProblem<E, G, F>::evaluate_individual(
+		std::shared_ptr<Individual<G, F>> individual, ThreadPool &pool,
+		const std::atomic<bool> *cancel) {
+
+	if (this->stream == nullptr) {
+		BlackBoxProblem<E, G, F>::evaluate_individual(individual, pool, cancel);
+		return;
+	}
+
+	std::vector<std::shared_ptr<Individual<G, F>>> individuals { individual };
+	this->evaluate_stream(individuals, &pool, cancel,
+			[](std::shared_ptr<Individual<G, F>>) {
+			});
+}
+
+/// @brief Evaluates several individuals at once. 
+/// @details With a streamed dataset, all individuals are evaluated with a single 
+/// pass over the dataset.
+/// @param individuals individuals to evaluate
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void SymbolicRegressionProblem<E, G, F>::evaluate_batch(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+
+	if (this->stream == nullptr) {
+		BlackBoxProblem<E, G, F>::evaluate_batch(individuals, cancel,
+				on_evaluated);
+		return;
+	}
+
+	this->evaluate_stream(individuals, nullptr, cancel, on_evaluated);
+}
+
+/// @brief Evaluates several individuals at once with the workers of a thread pool. 
+/// @details With a streamed dataset, all individuals are evaluated with a single 
+/// pass over the dataset and the shards of each block are shared by the workers.
+/// @param individuals individuals to evaluate
+/// @param pool thread pool whose workers evaluate the shards
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void SymbolicRegressionProblem<E, G, F>::evaluate_batch(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		ThreadPool &pool, const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+
+	if (this->stream == nullptr) {
+		BlackBoxProblem<E, G, F>::evaluate_batch(individuals, pool, cancel,
+				on_evaluated);
+		return;
+	}
+
+	this->evaluate_stream(individuals, &pool, cancel, on_evaluated);
+}
+
+/// @brief Returns whether the problem prefers to evaluate individuals in batches,
+/// which is the case for a streamed dataset.
+/// @return true if batches should be passed to evaluate_batch
+template<class E, class G, class F>
+bool SymbolicRegressionProblem<E, G, F>::is_batched() const {
+	return this->stream != nullptr;
+}
+
+/// @brief Evaluates individuals with a single pass over the streamed dataset.
+/// @details Each block is evaluated for all individuals before the next one is
+/// taken, so every block is read once per pass while the stream reads ahead in the 
+/// background. Within a block, the fitness cases are evaluated in shards whose partial
+/// errors are summed up in order, which gives the same fitness as the in-memory 
+/// evaluation. If a pool is passed, the shards of all individuals of a block are 
+/// distributed over its workers, each of which uses its own evaluator. If the 
+/// cancellation flag is set, the pass stops at the next block and the individuals 
+/// remain unevaluated.
+/// @param individuals individuals to evaluate
+/// @param pool thread pool whose workers evaluate the shards, or nullptr
+/// @param cancel optional cancellation flag
+/// @param on_evaluated function that is called for each evaluated individual
+template<class E, class G, class F>
+void SymbolicRegressionProblem<E, G, F>::evaluate_stream(
+		std::vector<std::shared_ptr<Individual<G, F>>> &individuals,
+		ThreadPool *pool, const std::atomic<bool> *cancel,
+		const std::function<void(std::shared_ptr<Individual<G, F>>)> &on_evaluated) {
+
+	std::vector<std::shared_ptr<Individual<G, F>>> pending;
+
+	for (auto &individual : individuals) {
+		if (individual->is_evaluated()) {
+#ifdef CGP_EVAL_COUNTERS
+			this->evaluator->get_counters()->count_evaluation_skip();
+#endif
+			continue;
+		}
+
+		if (!individual->is_decoded()) {
+			this->evaluator->decode_path(individual);
+		}
+#ifdef CGP_EVAL_COUNTERS
+		else {
+			this->evaluator->get_counters()->count_decode_skip();
+		}
+#endif
+
+		pending.push_back(individual);
+	}
+
+	if (pending.empty()) {
+		return;
+	}
+
+	std::vector<F> diffs(pending.size(), 0);
+
+	this->stream->rewind();
+
+	while (std::shared_ptr<const Dataset<E>> block = this->stream->next()) {
+		if (cancel != nullptr && *cancel) {
+			this->stream->stop();
+#ifdef CGP_EVAL_COUNTERS
+			this->evaluator->get_counters()->count_cancellation();
+#endif
+			return;
+		}
+
+		int size = block->get_num_instances();
+
+		if (pool != nullptr) {
+			while ((int) this->shard_evaluators.size() < pool->size()) {
+				this->shard_evaluators.push_back(
+						std::make_shared<Evaluator<E, G, F>>(*this->evaluator));
+			}
+
+			// The partial errors are summed up in shard order afterwards, so the
+			// fitness does not depend on the number of workers
+			int num_shards = (size + this->shard_size - 1) / this->shard_size;
+			std::vector<F> partial_diffs(pending.size() * num_shards, 0);
+
+			pool->run(partial_diffs.size(), [&](int task, int worker) {
+				int k = task / num_shards;
+				int begin = (task % num_shards) * this->shard_size;
+				int end = std::min(begin + this->shard_size, size);
+				partial_diffs[task] = this->evaluate_cases(pending[k], begin, end,
+						*this->shard_evaluators.at(worker), *block);
+			});
+
+			for (std::size_t k = 0; k < pending.size(); k++) {
+				for (int shard = 0; shard < num_shards; shard++) {
+					diffs[k] += partial_diffs[k * num_shards + shard];
+				}
+			}
+
+			continue;
+		}
+
+		for (std::size_t k = 0; k < pending.size(); k++) {
+			for (int begin = 0; begin < size; begin += this->shard_size) {
+				int end = std::min(begin + this->shard_size, size);
+				diffs[k] += this->evaluate_cases(pending[k], begin, end,
+						*this->evaluator, *block);
+			}
+		}
+	}
+
+	for (std::size_t k = 0; k < pending.size(); k++) {
+		pending[k]->set_fitness(diffs[k]);
+		pending[k]->set_evaluated(true);
+
+#ifdef CGP_EVAL_COUNTERS
+		this->evaluator->get_counters()->count_individual(
+				pending[k]->get_active_nodes()->size());
+#endif
+
+		on_evaluated(pending[k]);
+	}
 }
 
 /// @brief Evaluates the outputs on an individual against the real outputs of the problem.
@@ -0,0 +1,260 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: AllocCounters.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROFILING_ALLOCCOUNTERS_H_
+#define PROFILING_ALLOCCOUNTERS_H_
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <cstddef>
+#include <cstdint>
+
+/// @brief Counts the heap allocations of the phases of the evolutionary loop.
+/// @details Each thread counts its allocations and allocated bytes with plain
+/// thread-local counters, which are incremented by the replaced global operator new
+/// of profiling/AllocHooks.h. The counters are only incremented if the hooks are
+/// compiled into the program, i.e. if CGP++ is compiled with CGP_ALLOC_COUNTERS
+/// defined, in which case the algorithm creates the counters of a job. Like the
+/// hardware performance counters, the thread-local counts are read at the start
+/// and the end of a scope and the difference is added to the phase of the scope.
+/// A scope with null counters does nothing, and nested scopes are exclusive, e.g.
+/// the decoding within the breeding of a batch is only counted as decoding. The
+/// allocations of the job thread outside of the other phases are counted as other,
+/// whereas allocations of the evaluation workers outside of the scopes, e.g. by the
+/// thread pool, are not counted.
+class AllocCounters {
+public:
+	enum Phase {
+		DECODE, EVALUATE, SELECT, BREED, OTHER, NUM_PHASES
+	};
+
+	/// @brief Allocations of a thread since its start.
+	struct Sample {
+		std::uint64_t allocations = 0;
+		std::uint64_t bytes = 0;
+	};
+
+	/// @brief Adds the allocations between its construction and destruction to a phase.
+	/// @details The enclosing scope of the thread is paused while the scope is active.
+	class Scope {
+	private:
+		AllocCounters *counters;
+		Phase phase;
+		Sample start;
+		Scope *outer = nullptr;
+
+		static Scope*& active() {
+			thread_local Scope *scope = nullptr;
+			return scope;
+		}
+
+		friend class AllocCounters;
+
+	public:
+		Scope(AllocCounters *p_counters, Phase p_phase) :
+				counters(p_counters), phase(p_phase) {
+			if (counters == nullptr) {
+				return;
+			}
+
+			start = AllocCounters::read();
+
+			outer = active();
+			if (outer != nullptr) {
+				outer->counters->add(outer->phase, outer->start, start);
+			}
+			active() = this;
+		}
+
+		~Scope() {
+			if (counters == nullptr) {
+				return;
+			}
+
+			Sample end = AllocCounters::read();
+			counters->add(phase, start, end);
+
+			if (outer != nullptr) {
+				outer->start = end;
+			}
+			active() = outer;
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+private:
+	std::array<std::atomic<std::uint64_t>, NUM_PHASES> allocations;
+	std::array<std::atomic<std::uint64_t>, NUM_PHASES> bytes;
+
+	// Totals at the previous report during the job
+	std::uint64_t reported_allocations;
+	std::uint64_t reported_bytes;
+	int reported_generation;
+
+	static Sample& local() noexcept {
+		thread_local Sample sample;
+		return sample;
+	}
+
+public:
+	AllocCounters() {
+		this->reset();
+	}
+
+	/// @brief Counts an allocation of the calling thread.
+	/// @details Called by the replaced global operator new, so it must not allocate.
+	/// @param size number of bytes that have been requested
+	static void count(std::size_t size) noexcept {
+		Sample &sample = local();
+		sample.allocations++;
+		sample.bytes += size;
+	}
+
+	/// @brief Returns the allocations of the calling thread since its start.
+	/// @return allocations and bytes of the calling thread
+	static Sample read() noexcept {
+		return local();
+	}
+
+	/// @brief Adds the difference of two samples to a phase. Can be called concurrently.
+	/// @param phase phase the allocations belong to
+	/// @param start sample taken at the start of the phase
+	/// @param end sample taken at the end of the phase
+	void add(Phase phase, const Sample &start, const Sample &end) {
+		this->allocations[phase].fetch_add(end.allocations - start.allocations,
+				std::memory_order_relaxed);
+		this->bytes[phase].fetch_add(end.bytes - start.bytes,
+				std::memory_order_relaxed);
+	}
+
+	/// @brief Adds the pending allocations of the active scope of the calling
+	/// thread, e.g. before the counters are reported while the job is running.
+	void flush() {
+		Scope *scope = Scope::active();
+
+		if (scope != nullptr && scope->counters == this) {
+			Sample now = AllocCounters::read();
+			this->add(scope->phase, scope->start, now);
+			scope->start = now;
+		}
+	}
+
+	/// @brief Resets the counts, e.g. at the start of a job.
+	void reset() {
+		for (int i = 0; i < NUM_PHASES; i++) {
+			this->allocations[i] = 0;
+			this->bytes[i] = 0;
+		}
+
+		this->reported_allocations = 0;
+		this->reported_bytes = 0;
+		this->reported_generation = 0;
+	}
+
+	/// @brief Returns the allocations of a phase.
+	std::uint64_t get_allocations(Phase phase) const {
+		return this->allocations[phase];
+	}
+
+	/// @brief Returns the allocated bytes of a phase.
+	std::uint64_t get_bytes(Phase phase) const {
+		return this->bytes[phase];
+	}
+
+	/// @brief Returns the allocations of all phases.
+	std::uint64_t total_allocations() const {
+		std::uint64_t total = 0;
+		for (int i = 0; i < NUM_PHASES; i++) {
+			total += this->allocations[i];
+		}
+		return total;
+	}
+
+	/// @brief Returns the allocated bytes of all phases.
+	std::uint64_t total_bytes() const {
+		std::uint64_t total = 0;
+		for (int i = 0; i < NUM_PHASES; i++) {
+			total += this->bytes[i];
+		}
+		return total;
+	}
+
+	static const char* name(Phase phase) {
+		static const char *names[NUM_PHASES] = { "Decode", "Evaluate",
+				"Select", "Breed", "Other" };
+		return names[phase];
+	}
+
+	/// @brief Formats the allocations per generation since the previous call
+	/// as columns of the report during a job.
+	/// @param generation_number current generation number
+	/// @return labeled columns without trailing newline
+	std::string interval_to_string(int generation_number) {
+		this->flush();
+
+		std::uint64_t allocs = this->total_allocations();
+		std::uint64_t b = this->total_bytes();
+		int generations = std::max(1,
+				generation_number - this->reported_generation);
+
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(0) << " :: Allocations/generation: "
+				<< (double) (allocs - this->reported_allocations) / generations
+				<< " :: Bytes/generation: "
+				<< (double) (b - this->reported_bytes) / generations;
+
+		this->reported_allocations = allocs;
+		this->reported_bytes = b;
+		this->reported_generation = generation_number;
+
+		return ss.str();
+	}
+
+	/// @brief Formats the counts as columns of the job report.
+	/// @details The simple report lists the allocations and bytes of each phase in
+	/// the order of the Phase enum, followed by the allocations and bytes per generation.
+	/// @param simple true for space-separated values, false for labeled fields
+	/// @param num_generations number of generations of the job
+	/// @return columns without trailing newline
+	std::string to_string(bool simple, int num_generations) const {
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(0);
+
+		auto column = [&](const std::string &label, double value) {
+			ss << (simple ? " " : " :: " + label + ": ") << value;
+		};
+
+		for (int i = 0; i < NUM_PHASES; i++) {
+			Phase p = (Phase) i;
+			column(std::string(name(p)) + " allocations",
+					(double) this->get_allocations(p));
+			column(std::string(name(p)) + " bytes",
+					(double) this->get_bytes(p));
+		}
+
+		int generations = std::max(1, num_generations);
+
+		column("Allocations/generation",
+				(double) this->total_allocations() / generations);
+		column("Bytes/generation", (double) this->total_bytes() / generations);
+
+		return ss.str();
+	}
+};
+
+#endif /* PROFILING_ALLOCCOUNTERS_H_ */
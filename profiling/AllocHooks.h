@@ -0,0 +1,63 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: AllocHooks.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROFILING_ALLOCHOOKS_H_
+#define PROFILING_ALLOCHOOKS_H_
+
+#include <new>
+#include <cstdlib>
+
+#include "AllocCounters.h"
+
+// Replacements of the global operator new and delete that count the allocations
+// of the calling thread with AllocCounters. The replacements are definitions, so
+// this header must be included by exactly one translation unit of a program.
+// ---------------------------------------------------------------------------------------
+
+/// @brief Counts and performs an allocation.
+/// @param size number of bytes to allocate
+/// @return pointer to the allocated memory
+inline void* alloc_hooks_allocate(std::size_t size) {
+	AllocCounters::count(size);
+
+	void *p = std::malloc(size == 0 ? 1 : size);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new(std::size_t size) {
+	return alloc_hooks_allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+	return alloc_hooks_allocate(size);
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+	std::free(p);
+}
+
+#endif /* PROFILING_ALLOCHOOKS_H_ */
@@ -0,0 +1,184 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: EvalCounters.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROFILING_EVALCOUNTERS_H_
+#define PROFILING_EVALCOUNTERS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <iomanip>
+
+/// @brief Counts the work done by the evaluators of a problem.
+/// @details Only used if CGP++ is compiled with CGP_EVAL_COUNTERS defined, otherwise
+/// the counting is compiled out. The counters are shared by the problem, its clones
+/// and their evaluators, so they can be updated concurrently. Fitness cases and
+/// node evaluations are counted per range of cases rather than per case. The active
+/// node counts of the evaluated individuals are collected in a histogram with
+/// power-of-two bins: 0, 1, 2-3, 4-7 and so on.
+class EvalCounters {
+public:
+	static constexpr int NUM_BINS = 32;
+
+private:
+	std::atomic<long long> individuals;
+	std::atomic<long long> fitness_cases;
+	std::atomic<long long> node_evaluations;
+	std::atomic<long long> decodes;
+	std::atomic<long long> decode_skips;
+	std::atomic<long long> evaluation_skips;
+	std::atomic<long long> cancellations;
+	std::array<std::atomic<long long>, NUM_BINS> histogram;
+
+	std::chrono::steady_clock::time_point start;
+
+	static int bin(long long num_active_nodes) {
+		int b = 0;
+		while (num_active_nodes > 0 && b < NUM_BINS - 1) {
+			num_active_nodes >>= 1;
+			b++;
+		}
+		return b;
+	}
+
+public:
+	EvalCounters() {
+		this->reset();
+	}
+
+	/// @brief Resets the counters and the time base, e.g. at the start of a job.
+	void reset() {
+		individuals = 0;
+		fitness_cases = 0;
+		node_evaluations = 0;
+		decodes = 0;
+		decode_skips = 0;
+		evaluation_skips = 0;
+		cancellations = 0;
+
+		for (auto &h : histogram) {
+			h = 0;
+		}
+
+		start = std::chrono::steady_clock::now();
+	}
+
+	/// @brief Counts a decoding of an active path.
+	void count_decode() {
+		decodes.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// @brief Counts an individual whose active path has been decoded already.
+	void count_decode_skip() {
+		decode_skips.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// @brief Counts an individual that has been evaluated already.
+	void count_evaluation_skip() {
+		evaluation_skips.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// @brief Counts an evaluation that has been stopped by the cancellation flag.
+	void count_cancellation() {
+		cancellations.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	/// @brief Counts a range of fitness cases that has been evaluated.
+	/// @param num_cases number of fitness cases of the range
+	/// @param num_active_nodes number of active nodes of the individual
+	void count_cases(int num_cases, long long num_active_nodes) {
+		fitness_cases.fetch_add(num_cases, std::memory_order_relaxed);
+		node_evaluations.fetch_add(num_cases * num_active_nodes,
+				std::memory_order_relaxed);
+	}
+
+	/// @brief Counts a completed evaluation of an individual.
+	/// @param num_active_nodes number of active nodes of the individual
+	void count_individual(long long num_active_nodes) {
+		individuals.fetch_add(1, std::memory_order_relaxed);
+		histogram[bin(num_active_nodes)].fetch_add(1,
+				std::memory_order_relaxed);
+	}
+
+	long long get_node_evaluations() const {
+		return node_evaluations;
+	}
+
+	long long get_fitness_cases() const {
+		return fitness_cases;
+	}
+
+	/// @brief Returns the number of node evaluations per second since the last reset.
+	/// @return node evaluations per second
+	double node_evaluations_per_second() const {
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now()
+				- start;
+		return elapsed.count() > 0.0 ? node_evaluations / elapsed.count() : 0.0;
+	}
+
+	/// @brief Formats the counters as columns of a report.
+	/// @details The simple format lists the values in the order of the labeled format.
+	/// The histogram lists the non-empty bins as comma-separated pairs of the
+	/// range of active nodes and the count.
+	/// @param simple true for space-separated values, false for labeled fields
+	/// @return columns without trailing newline
+	std::string to_string(bool simple) const {
+		std::stringstream ss;
+		ss << std::fixed << std::setprecision(0);
+
+		const char *labels[] = { "Individuals", "Fitness cases",
+				"Node evaluations", "Node evaluations/s", "Decodes",
+				"Decode skips", "Evaluation skips", "Cancelled" };
+		double values[] = { (double) individuals, (double) fitness_cases,
+				(double) node_evaluations, this->node_evaluations_per_second(),
+				(double) decodes, (double) decode_skips,
+				(double) evaluation_skips, (double) cancellations };
+
+		for (int i = 0; i < 8; i++) {
+			if (simple) {
+				ss << " " << values[i];
+			} else {
+				ss << " :: " << labels[i] << ": " << values[i];
+			}
+		}
+
+		ss << (simple ? " " : " :: Active nodes: ");
+
+		bool first = true;
+		for (int b = 0; b < NUM_BINS; b++) {
+			if (histogram[b] == 0) {
+				continue;
+			}
+
+			long long low = b == 0 ? 0 : 1LL << (b - 1);
+			long long high = b == 0 ? 0 : (1LL << b) - 1;
+
+			ss << (first ? "" : ",") << low;
+			if (high > low) {
+				ss << "-" << high;
+			}
+			ss << ":" << histogram[b];
+
+			first = false;
+		}
+
+		if (first) {
+			ss << "-";
+		}
+
+		return ss.str();
+	}
+};
+
+#endif /* PROFILING_EVALCOUNTERS_H_ */
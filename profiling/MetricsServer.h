@@ -0,0 +1,381 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: MetricsServer.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROFILING_METRICSSERVER_H_
+#define PROFILING_METRICSSERVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstring>
+#include <stdexcept>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+/// @brief Current state of a running job, which is published by its algorithm.
+/// @details All values are atomics that are updated without locking, so publishing
+/// does not block the evolutionary loop. The cache hit ratios refer to the
+/// individuals that are passed to the evaluation: the fitness cache is hit by
+/// individuals that have been evaluated already, e.g. the parents, the decode
+/// cache by individuals whose genome is unchanged since the last decoding.
+class JobMetrics {
+private:
+	std::chrono::steady_clock::time_point start;
+
+	std::atomic<long long> generation;
+	std::atomic<long long> fitness_evaluations;
+	std::atomic<double> best_fitness;
+
+	std::atomic<long long> lookups;
+	std::atomic<long long> fitness_hits;
+	std::atomic<long long> decode_hits;
+
+	std::atomic<long long> evaluated;
+	std::atomic<long long> active_nodes;
+
+	std::atomic<long long> checkpoint_time;
+
+	long long now() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - this->start).count();
+	}
+
+public:
+	JobMetrics() :
+			start(std::chrono::steady_clock::now()), generation(0), fitness_evaluations(
+					0), best_fitness(0.0), lookups(0), fitness_hits(0), decode_hits(
+					0), evaluated(0), active_nodes(0), checkpoint_time(-1) {
+	}
+
+	/// @brief Publishes the progress of the job.
+	/// @param p_generation current generation
+	/// @param p_fitness_evaluations fitness evaluations performed so far
+	/// @param p_best_fitness best fitness found so far
+	void publish(long long p_generation, long long p_fitness_evaluations,
+			double p_best_fitness) {
+		this->generation.store(p_generation, std::memory_order_relaxed);
+		this->fitness_evaluations.store(p_fitness_evaluations,
+				std::memory_order_relaxed);
+		this->best_fitness.store(p_best_fitness, std::memory_order_relaxed);
+	}
+
+	/// @brief Counts an individual that is passed to the evaluation.
+	/// @param is_evaluated true if the fitness of the individual is known
+	/// @param is_decoded true if the active path of the individual is known
+	void count_lookup(bool is_evaluated, bool is_decoded) {
+		this->lookups.fetch_add(1, std::memory_order_relaxed);
+		if (is_evaluated) {
+			this->fitness_hits.fetch_add(1, std::memory_order_relaxed);
+		} else if (is_decoded) {
+			this->decode_hits.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	/// @brief Counts an evaluated individual.
+	/// @param num_active_nodes number of active nodes of the individual
+	void count_evaluation(long long num_active_nodes) {
+		this->evaluated.fetch_add(1, std::memory_order_relaxed);
+		this->active_nodes.fetch_add(num_active_nodes,
+				std::memory_order_relaxed);
+	}
+
+	/// @brief Records that a checkpoint has been written.
+	void count_checkpoint() {
+		this->checkpoint_time.store(this->now(), std::memory_order_relaxed);
+	}
+
+	long long get_generation() const {
+		return this->generation;
+	}
+
+	long long get_fitness_evaluations() const {
+		return this->fitness_evaluations;
+	}
+
+	double get_best_fitness() const {
+		return this->best_fitness;
+	}
+
+	/// @brief Returns the fitness evaluations per second since the start of the job.
+	double evaluations_per_second() const {
+		double seconds = this->now() * 1e-9;
+		return seconds > 0.0 ? this->fitness_evaluations / seconds : 0.0;
+	}
+
+	/// @brief Returns the mean number of active nodes of the evaluated individuals.
+	double mean_active_nodes() const {
+		long long n = this->evaluated;
+		return n > 0 ? (double) this->active_nodes / n : 0.0;
+	}
+
+	double fitness_hit_ratio() const {
+		long long n = this->lookups;
+		return n > 0 ? (double) this->fitness_hits / n : 0.0;
+	}
+
+	/// @brief Returns the ratio of decode cache hits among the individuals that are not evaluated.
+	double decode_hit_ratio() const {
+		long long n = this->lookups - this->fitness_hits;
+		return n > 0 ? (double) this->decode_hits / n : 0.0;
+	}
+
+	/// @brief Returns the time since the last checkpoint has been written.
+	/// @return age in seconds or a negative value if no checkpoint has been written
+	double checkpoint_age() const {
+		long long t = this->checkpoint_time;
+		return t < 0 ? -1.0 : (this->now() - t) * 1e-9;
+	}
+};
+
+/// @brief Serves the metrics of the running jobs on a Unix domain socket in the
+/// Prometheus text exposition format.
+/// @details A background thread accepts the connections and answers each of them
+/// with the current metrics, then closes it. Clients that send an HTTP request
+/// within a short time, e.g. curl --unix-socket, obtain an HTTP response; other
+/// clients, e.g. socat, obtain the plain metrics. The jobs are only locked to register
+/// and unregister them, never by the algorithms, so the evolutionary loop is not
+/// blocked by a slow client.
+class MetricsServer {
+private:
+	std::string path;
+	int listen_fd;
+	std::atomic<bool> shutdown;
+	std::thread thread;
+
+	std::mutex mtx;
+	std::map<int, std::shared_ptr<JobMetrics>> jobs;
+
+	static constexpr int POLL_TIMEOUT_MS = 200;
+	static constexpr int REQUEST_TIMEOUT_MS = 100;
+
+	void serve();
+	void answer(int fd);
+
+	static double resident_memory();
+
+public:
+	MetricsServer(const std::string &p_path);
+	virtual ~MetricsServer();
+
+	MetricsServer(const MetricsServer&) = delete;
+	MetricsServer& operator=(const MetricsServer&) = delete;
+
+	std::shared_ptr<JobMetrics> add(int job);
+	void remove(int job);
+	std::string to_string();
+};
+
+/// @brief Constructor that binds the socket and starts serving.
+/// @details A stale socket file of a previous run is replaced.
+/// @param p_path path of the socket file
+inline MetricsServer::MetricsServer(const std::string &p_path) {
+	path = p_path;
+	shutdown = false;
+
+	sockaddr_un address { };
+	address.sun_family = AF_UNIX;
+
+	if (path.size() >= sizeof(address.sun_path)) {
+		throw std::invalid_argument("Metrics socket path is too long!");
+	}
+
+	std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listen_fd < 0) {
+		throw std::runtime_error("Could not create the metrics socket!");
+	}
+
+	unlink(path.c_str());
+
+	if (bind(listen_fd, (sockaddr*) &address, sizeof(address)) != 0
+			|| listen(listen_fd, 8) != 0) {
+		close(listen_fd);
+		throw std::runtime_error("Could not bind the metrics socket " + path);
+	}
+
+	thread = std::thread(&MetricsServer::serve, this);
+}
+
+/// @brief Destructor that stops serving and removes the socket file.
+inline MetricsServer::~MetricsServer() {
+	shutdown = true;
+
+	if (thread.joinable()) {
+		thread.join();
+	}
+
+	close(listen_fd);
+	unlink(path.c_str());
+}
+
+/// @brief Registers a job whose metrics are served.
+/// @param job job number
+/// @return metrics the algorithm of the job publishes to
+inline std::shared_ptr<JobMetrics> MetricsServer::add(int job) {
+	std::lock_guard<std::mutex> lock(this->mtx);
+	std::shared_ptr<JobMetrics> metrics = std::make_shared<JobMetrics>();
+	this->jobs[job] = metrics;
+	return metrics;
+}
+
+/// @brief Unregisters a finished job.
+/// @param job job number
+inline void MetricsServer::remove(int job) {
+	std::lock_guard<std::mutex> lock(this->mtx);
+	this->jobs.erase(job);
+}
+
+/// @brief Accepts connections until the server is shut down.
+inline void MetricsServer::serve() {
+	pollfd listener { listen_fd, POLLIN, 0 };
+
+	while (!shutdown) {
+		if (poll(&listener, 1, POLL_TIMEOUT_MS) <= 0) {
+			continue;
+		}
+
+		int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+		if (fd >= 0) {
+			this->answer(fd);
+			close(fd);
+		}
+	}
+}
+
+/// @brief Answers a connection with the current metrics.
+/// @param fd socket of the connection
+inline void MetricsServer::answer(int fd) {
+	std::string body = this->to_string();
+	std::string response = body;
+
+	pollfd client { fd, POLLIN, 0 };
+	char request[512];
+
+	if (poll(&client, 1, REQUEST_TIMEOUT_MS) > 0) {
+		ssize_t received = recv(fd, request, sizeof(request), MSG_DONTWAIT);
+		if (received >= 3 && std::strncmp(request, "GET", 3) == 0) {
+			std::stringstream ss;
+			ss << "HTTP/1.0 200 OK\r\n"
+					<< "Content-Type: text/plain; version=0.0.4\r\n"
+					<< "Content-Length: " << body.size() << "\r\n\r\n"
+					<< body;
+			response = ss.str();
+		}
+	}
+
+	const char *bytes = response.data();
+	std::size_t size = response.size();
+
+	while (size > 0) {
+		ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+		if (written <= 0) {
+			return;
+		}
+		bytes += written;
+		size -= written;
+	}
+}
+
+/// @brief Returns the resident set size of the process.
+/// @return size in bytes or 0 if it can not be determined
+inline double MetricsServer::resident_memory() {
+	std::ifstream ifs("/proc/self/statm");
+	long long pages = 0;
+	long long resident = 0;
+
+	if (ifs >> pages >> resident) {
+		return (double) resident * sysconf(_SC_PAGESIZE);
+	}
+
+	return 0.0;
+}
+
+/// @brief Formats the metrics of the running jobs in the Prometheus text format.
+/// @return exposition of the metrics
+inline std::string MetricsServer::to_string() {
+	std::map<int, std::shared_ptr<JobMetrics>> current;
+	{
+		std::lock_guard<std::mutex> lock(this->mtx);
+		current = this->jobs;
+	}
+
+	std::stringstream ss;
+	ss.precision(10);
+
+	auto family = [&](const char *name, const char *type, const char *help,
+			double (*value)(const JobMetrics&), bool skip_negative) {
+		ss << "# HELP " << name << " " << help << "\n";
+		ss << "# TYPE " << name << " " << type << "\n";
+		for (auto &job : current) {
+			double v = value(*job.second);
+			if (!skip_negative || v >= 0.0) {
+				ss << name << "{job=\"" << job.first << "\"} " << v << "\n";
+			}
+		}
+	};
+
+	family("cgp_generation", "gauge", "Current generation of the job.",
+			[](const JobMetrics &m) {
+				return (double) m.get_generation();
+			}, false);
+	family("cgp_best_fitness", "gauge", "Best fitness found so far.",
+			[](const JobMetrics &m) {
+				return m.get_best_fitness();
+			}, false);
+	family("cgp_fitness_evaluations_total", "counter",
+			"Fitness evaluations performed so far.", [](const JobMetrics &m) {
+				return (double) m.get_fitness_evaluations();
+			}, false);
+	family("cgp_evaluations_per_second", "gauge",
+			"Fitness evaluations per second since the start of the job.",
+			[](const JobMetrics &m) {
+				return m.evaluations_per_second();
+			}, false);
+	family("cgp_active_nodes_mean", "gauge",
+			"Mean number of active nodes of the evaluated individuals.",
+			[](const JobMetrics &m) {
+				return m.mean_active_nodes();
+			}, false);
+	family("cgp_fitness_cache_hit_ratio", "gauge",
+			"Ratio of individuals whose fitness is known when passed to the evaluation.",
+			[](const JobMetrics &m) {
+				return m.fitness_hit_ratio();
+			}, false);
+	family("cgp_decode_cache_hit_ratio", "gauge",
+			"Ratio of unevaluated individuals whose active path is known.",
+			[](const JobMetrics &m) {
+				return m.decode_hit_ratio();
+			}, false);
+	family("cgp_checkpoint_age_seconds", "gauge",
+			"Time since the last checkpoint has been written.",
+			[](const JobMetrics &m) {
+				return m.checkpoint_age();
+			}, true);
+
+	ss << "# HELP cgp_resident_memory_bytes Resident set size of the process.\n";
+	ss << "# TYPE cgp_resident_memory_bytes gauge\n";
+	ss << "cgp_resident_memory_bytes " << resident_memory() << "\n";
+
+	return ss.str();
+}
+
+#endif /* PROFILING_METRICSSERVER_H_ */
@@ -0,0 +1,308 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: PerfCounters.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROFILING_PERFCOUNTERS_H_
+#define PROFILING_PERFCOUNTERS_H_
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/// @brief Samples the hardware performance counters of the threads that run the
+/// decode, evaluate and breed phases of the evolutionary loop.
+/// @details Each thread opens its own group of counters with perf_event_open the
+/// first time it enters a scope. The group counts user space cycles, instructions,
+/// cache misses and branch misses as well as the task clock, and is read with a
+/// single system call at the start and the end of a scope. Events the kernel does
+/// not provide, e.g. in virtual machines without a PMU, are left out of the group.
+/// If no event can be opened, e.g. because perf_event_paranoid forbids access, or
+/// on other operating systems, the scopes do nothing. Nested scopes are exclusive,
+/// e.g. the decoding within the breeding of a batch is only counted as decoding.
+class PerfCounters {
+public:
+	enum Event {
+		CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, TASK_CLOCK, NUM_EVENTS
+	};
+
+	enum Phase {
+		DECODE, EVALUATE, BREED, NUM_PHASES
+	};
+
+	/// @brief Counter values of the calling thread and the events they cover.
+	struct Sample {
+		std::array<std::uint64_t, NUM_EVENTS> values { };
+		unsigned int events = 0;
+	};
+
+	/// @brief Adds the counts between its construction and destruction to a phase.
+	/// @details The enclosing scope of the thread is paused while the scope is active.
+	class Scope {
+	private:
+		PerfCounters *counters;
+		Phase phase;
+		Sample start;
+		Scope *outer = nullptr;
+
+		static Scope*& active() {
+			thread_local Scope *scope = nullptr;
+			return scope;
+		}
+
+	public:
+		Scope(PerfCounters *p_counters, Phase p_phase) :
+				counters(p_counters), phase(p_phase) {
+			if (counters == nullptr || !PerfCounters::read(start)) {
+				counters = nullptr;
+				return;
+			}
+
+			outer = active();
+			if (outer != nullptr) {
+				outer->counters->add(outer->phase, outer->start, start);
+			}
+			active() = this;
+		}
+
+		~Scope() {
+			if (counters == nullptr) {
+				return;
+			}
+
+			Sample end;
+			if (PerfCounters::read(end)) {
+				counters->add(phase, start, end);
+				if (outer != nullptr) {
+					outer->start = end;
+				}
+			}
+			active() = outer;
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+private:
+	/// @brief Counter group of a thread, which is closed when the thread exits.
+	class Group {
+	public:
+		std::vector<int> fds;
+		std::vector<Event> events;
+
+		Group() {
+#ifdef __linux__
+			for (int e = 0; e < NUM_EVENTS; e++) {
+				int fd = open_event((Event) e, fds.empty() ? -1 : fds.front());
+				if (fd >= 0) {
+					fds.push_back(fd);
+					events.push_back((Event) e);
+				}
+			}
+#endif
+		}
+
+		~Group() {
+#ifdef __linux__
+			for (int fd : fds) {
+				close(fd);
+			}
+#endif
+		}
+	};
+
+	std::array<std::array<std::atomic<std::uint64_t>, NUM_EVENTS>, NUM_PHASES> totals;
+	std::atomic<unsigned int> events;
+	std::atomic<long long> node_evaluations;
+
+	static Group& group() {
+		thread_local Group g;
+		return g;
+	}
+
+#ifdef __linux__
+	static int open_event(Event event, int group_fd) {
+		struct perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.read_format = PERF_FORMAT_GROUP;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		switch (event) {
+		case CYCLES:
+			attr.config = PERF_COUNT_HW_CPU_CYCLES;
+			break;
+		case INSTRUCTIONS:
+			attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+			break;
+		case CACHE_MISSES:
+			attr.config = PERF_COUNT_HW_CACHE_MISSES;
+			break;
+		case BRANCH_MISSES:
+			attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+			break;
+		default:
+			attr.type = PERF_TYPE_SOFTWARE;
+			attr.config = PERF_COUNT_SW_TASK_CLOCK;
+			break;
+		}
+
+		return (int) syscall(SYS_perf_event_open, &attr, 0, -1, group_fd, 0);
+	}
+#endif
+
+public:
+	PerfCounters() {
+		this->reset();
+	}
+
+	/// @brief Reads the counters of the calling thread and opens them if required.
+	/// @param sample sample the values are written to
+	/// @return false if no counter is available
+	static bool read(Sample &sample) {
+#ifdef __linux__
+		Group &g = group();
+
+		if (g.fds.empty()) {
+			return false;
+		}
+
+		std::uint64_t buffer[NUM_EVENTS + 1];
+		ssize_t size = (g.fds.size() + 1) * sizeof(std::uint64_t);
+
+		if (::read(g.fds.front(), buffer, size) != size) {
+			return false;
+		}
+
+		sample.events = 0;
+		for (std::size_t i = 0; i < g.events.size(); i++) {
+			sample.values[g.events[i]] = buffer[i + 1];
+			sample.events |= 1u << g.events[i];
+		}
+
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	/// @brief Adds the difference of two samples to a phase. Can be called concurrently.
+	/// @param phase phase the counts belong to
+	/// @param start sample taken at the start of the phase
+	/// @param end sample taken at the end of the phase
+	void add(Phase phase, const Sample &start, const Sample &end) {
+		for (int e = 0; e < NUM_EVENTS; e++) {
+			if (end.events & (1u << e)) {
+				this->totals[phase][e].fetch_add(end.values[e] - start.values[e],
+						std::memory_order_relaxed);
+			}
+		}
+		this->events.fetch_or(end.events, std::memory_order_relaxed);
+	}
+
+	/// @brief Counts node evaluations, which serve as the unit of work of the evaluation.
+	/// @param num_node_evaluations number of fitness cases times the number of active nodes
+	void count_node_evaluations(long long num_node_evaluations) {
+		this->node_evaluations.fetch_add(num_node_evaluations,
+				std::memory_order_relaxed);
+	}
+
+	/// @brief Resets the accumulated counts, e.g. at the start of a job.
+	void reset() {
+		for (auto &phase : this->totals) {
+			for (auto &t : phase) {
+				t = 0;
+			}
+		}
+		this->events = 0;
+		this->node_evaluations = 0;
+	}
+
+	/// @brief Returns whether an event has been counted by any thread.
+	bool has(Event event) const {
+		return this->events & (1u << event);
+	}
+
+	/// @brief Returns the accumulated count of an event in a phase.
+	std::uint64_t get(Phase phase, Event event) const {
+		return this->totals[phase][event];
+	}
+
+	static const char* name(Phase phase) {
+		static const char *names[NUM_PHASES] = { "Decode", "Evaluate", "Breed" };
+		return names[phase];
+	}
+
+	/// @brief Formats the counts as columns of the job report.
+	/// @details For each phase, the cycles, instructions, instructions per cycle,
+	/// cache misses, branch misses and the CPU time are listed, followed by the cache
+	/// and branch misses of the evaluation per node evaluation. Values of events
+	/// that are not available are printed as a dash, so the number of columns
+	/// of the simple report does not depend on the machine.
+	/// @param simple true for space-separated values, false for labeled fields
+	/// @return columns without trailing newline
+	std::string to_string(bool simple) const {
+		std::stringstream ss;
+
+		auto column = [&](const std::string &label, bool available,
+				double value) {
+			ss << (simple ? " " : " :: " + label + ": ");
+			if (available) {
+				ss << value;
+			} else {
+				ss << "-";
+			}
+		};
+
+		for (int i = 0; i < NUM_PHASES; i++) {
+			Phase p = (Phase) i;
+			std::string n = name(p);
+			double cycles = this->get(p, CYCLES);
+			double instructions = this->get(p, INSTRUCTIONS);
+
+			column(n + " cycles", this->has(CYCLES), cycles);
+			column(n + " instructions", this->has(INSTRUCTIONS), instructions);
+			column(n + " IPC", this->has(CYCLES) && this->has(INSTRUCTIONS),
+					cycles > 0 ? instructions / cycles : 0.0);
+			column(n + " cache misses", this->has(CACHE_MISSES),
+					this->get(p, CACHE_MISSES));
+			column(n + " branch misses", this->has(BRANCH_MISSES),
+					this->get(p, BRANCH_MISSES));
+			column(n + " CPU (s)", this->has(TASK_CLOCK),
+					this->get(p, TASK_CLOCK) * 1e-9);
+		}
+
+		double nodes = this->node_evaluations;
+
+		column("Cache misses/node evaluation",
+				this->has(CACHE_MISSES) && nodes > 0,
+				this->get(EVALUATE, CACHE_MISSES) / nodes);
+		column("Branch misses/node evaluation",
+				this->has(BRANCH_MISSES) && nodes > 0,
+				this->get(EVALUATE, BRANCH_MISSES) / nodes);
+
+		return ss.str();
+	}
+};
+
+#endif /* PROFILING_PERFCOUNTERS_H_ */
@@ -0,0 +1,163 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: PhaseTimer.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROFILING_PHASETIMER_H_
+#define PROFILING_PHASETIMER_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+
+/// @brief Accumulates the wall time that a job spends in the phases of the evolutionary loop.
+/// @details The phases are timed with scopes that are placed around the respective calls.
+/// A scope with a null timer does nothing, so timing can be disabled without
+/// branching at the call sites. Decoding is timed by the evaluators and therefore
+/// summed over the evaluation threads, which means it is part of the evaluation time.
+/// The busy time of each evaluation worker is recorded separately to reveal load imbalance.
+class PhaseTimer {
+public:
+	enum Phase {
+		DECODE, EVALUATE, SELECT, BREED, REPORT, CHECKPOINT, NUM_PHASES
+	};
+
+	/// @brief Adds the time between its construction and destruction to a phase.
+	class Scope {
+	private:
+		PhaseTimer *timer;
+		Phase phase;
+		std::chrono::steady_clock::time_point start;
+
+	public:
+		Scope(PhaseTimer *p_timer, Phase p_phase) :
+				timer(p_timer), phase(p_phase) {
+			if (timer != nullptr) {
+				start = std::chrono::steady_clock::now();
+			}
+		}
+
+		~Scope() {
+			if (timer != nullptr) {
+				timer->add(phase, std::chrono::steady_clock::now() - start);
+			}
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+private:
+	std::array<std::atomic<long long>, NUM_PHASES> nanoseconds;
+	std::vector<double> worker_seconds;
+
+public:
+	PhaseTimer() {
+		this->reset();
+	}
+
+	/// @brief Adds a duration to a phase. Can be called concurrently.
+	/// @param phase phase the duration belongs to
+	/// @param duration duration to add
+	void add(Phase phase, std::chrono::steady_clock::duration duration) {
+		this->nanoseconds[phase] += std::chrono::duration_cast<
+				std::chrono::nanoseconds>(duration).count();
+	}
+
+	/// @brief Resets the accumulated times, e.g. at the start of a job.
+	void reset() {
+		for (auto &n : this->nanoseconds) {
+			n = 0;
+		}
+		this->worker_seconds.clear();
+	}
+
+	/// @brief Returns the accumulated time of a phase.
+	/// @param phase phase
+	/// @return time in seconds
+	double seconds(Phase phase) const {
+		return this->nanoseconds[phase] * 1e-9;
+	}
+
+	/// @brief Sets the busy times of the evaluation workers.
+	/// @param p_worker_seconds busy time of each worker in seconds
+	void set_worker_seconds(const std::vector<double> &p_worker_seconds) {
+		this->worker_seconds = p_worker_seconds;
+	}
+
+	/// @brief Returns the busy times of the evaluation workers.
+	/// @details Without a thread pool, the evaluation is done by the calling thread alone.
+	/// @return busy time of each worker in seconds
+	std::vector<double> get_worker_seconds() const {
+		if (this->worker_seconds.empty()) {
+			return std::vector<double> { this->seconds(EVALUATE) };
+		}
+		return this->worker_seconds;
+	}
+
+	/// @brief Returns the ratio of the maximum to the mean busy time of the workers.
+	/// @return 1.0 for a perfectly balanced evaluation
+	double imbalance() const {
+		std::vector<double> workers = this->get_worker_seconds();
+		double sum = 0.0;
+
+		for (double w : workers) {
+			sum += w;
+		}
+
+		if (sum <= 0.0) {
+			return 1.0;
+		}
+
+		double max = *std::max_element(workers.begin(), workers.end());
+		return max / (sum / workers.size());
+	}
+
+	static const char* name(Phase phase) {
+		static const char *names[NUM_PHASES] = { "Decode", "Evaluate",
+				"Select", "Breed", "Report", "Checkpoint" };
+		return names[phase];
+	}
+
+	/// @brief Formats the times as columns of the job report.
+	/// @details The simple report lists the phases in the order of the Phase enum,
+	/// followed by the comma-separated worker times and the imbalance.
+	/// @param simple true for space-separated values, false for labeled fields
+	/// @return columns without trailing newline
+	std::string to_string(bool simple) const {
+		std::stringstream ss;
+
+		for (int i = 0; i < NUM_PHASES; i++) {
+			if (simple) {
+				ss << " " << this->seconds((Phase) i);
+			} else {
+				ss << " :: " << name((Phase) i) << " (s): "
+						<< this->seconds((Phase) i);
+			}
+		}
+
+		std::vector<double> workers = this->get_worker_seconds();
+		ss << (simple ? " " : " :: Workers (s): ");
+
+		for (std::size_t i = 0; i < workers.size(); i++) {
+			ss << workers.at(i) << (i < workers.size() - 1 ? "," : "");
+		}
+
+		ss << (simple ? " " : " :: Imbalance: ") << this->imbalance();
+
+		return ss.str();
+	}
+};
+
+#endif /* PROFILING_PHASETIMER_H_ */
@@ -0,0 +1,244 @@
+//	CGP++: Modern C++ Implementation of Cartesian Genetic Programming
+// ===============================================================================
+//	File: Tracer.h
+// ===============================================================================
+//
+// ===============================================================================
+//  Copyright (C) 2024
+//
+//
+//	License: Academic Free License v. 3.0
+// ================================================================================
+
+#ifndef PROFILING_TRACER_H_
+#define PROFILING_TRACER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+
+/// @brief Records a timeline of the generations, phases, evaluations and checkpoint
+/// writes of a job in the Chrome trace event format.
+/// @details The spans are recorded into a ring buffer per thread. A thread registers
+/// its buffer with the first span, which is the only time a lock is taken, so the
+/// threads record without synchronizing with each other. If a buffer is full, the
+/// oldest spans of the thread are overwritten. The buffers are written to a JSON file
+/// at the end of the job, when no thread records anymore, and can be opened with
+/// Perfetto or chrome://tracing. Each job appears as a process and each thread that
+/// has recorded spans as a thread of the process.
+class Tracer {
+public:
+	static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+	/// @brief Span of the timeline. Arguments that are negative are not written.
+	struct Event {
+		const char *name;
+		const char *category;
+		std::int64_t begin;
+		std::int64_t duration;
+		int generation;
+		int individual;
+		int active_nodes;
+	};
+
+	/// @brief Records the time between its construction and destruction as a span.
+	/// @details A span with a null tracer does nothing.
+	class Span {
+	private:
+		Tracer *tracer;
+		Event event;
+
+	public:
+		Span(Tracer *p_tracer, const char *p_name, const char *p_category,
+				int p_generation = -1, int p_individual = -1) :
+				tracer(p_tracer) {
+			if (tracer != nullptr) {
+				event = { p_name, p_category, tracer->now(), 0, p_generation,
+						p_individual, -1 };
+			}
+		}
+
+		~Span() {
+			if (tracer != nullptr) {
+				event.duration = tracer->now() - event.begin;
+				tracer->record(event);
+			}
+		}
+
+		/// @brief Sets the number of active nodes of the individual of the span.
+		void set_active_nodes(int p_active_nodes) {
+			event.active_nodes = p_active_nodes;
+		}
+
+		Span(const Span&) = delete;
+		Span& operator=(const Span&) = delete;
+	};
+
+private:
+	/// @brief Ring buffer of a thread, which is filled by this thread only.
+	struct Buffer {
+		std::thread::id thread;
+		std::vector<Event> events;
+		std::atomic<std::uint64_t> head { 0 };
+	};
+
+	/// @brief Buffer of the calling thread for the tracer with the given id.
+	struct Slot {
+		std::uint64_t tracer = 0;
+		Buffer *buffer = nullptr;
+	};
+
+	static inline std::atomic<std::uint64_t> next_id { 1 };
+
+	std::uint64_t id;
+	std::chrono::steady_clock::time_point start;
+	std::mutex mtx;
+	std::vector<std::unique_ptr<Buffer>> buffers;
+
+	static Slot& slot() {
+		thread_local Slot s;
+		return s;
+	}
+
+	std::int64_t now() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - this->start).count();
+	}
+
+	Buffer* buffer() {
+		Slot &s = slot();
+
+		if (s.tracer == this->id) {
+			return s.buffer;
+		}
+
+		std::lock_guard<std::mutex> lock(this->mtx);
+		std::thread::id thread = std::this_thread::get_id();
+		Buffer *b = nullptr;
+
+		for (auto &candidate : this->buffers) {
+			if (candidate->thread == thread) {
+				b = candidate.get();
+			}
+		}
+
+		if (b == nullptr) {
+			this->buffers.push_back(std::make_unique<Buffer>());
+			b = this->buffers.back().get();
+			b->thread = thread;
+		}
+
+		s.tracer = this->id;
+		s.buffer = b;
+		return b;
+	}
+
+	void record(const Event &event) {
+		Buffer *b = this->buffer();
+		std::uint64_t head = b->head.load(std::memory_order_relaxed);
+
+		// The buffer grows up to its size, so short-lived threads stay small
+		if (b->events.size() < BUFFER_SIZE) {
+			b->events.push_back(event);
+		} else {
+			b->events[head % BUFFER_SIZE] = event;
+		}
+
+		b->head.store(head + 1, std::memory_order_release);
+	}
+
+	static void write_event(std::ofstream &ofs, const Event &event, int pid,
+			int tid) {
+		ofs << "{\"name\":\"" << event.name << "\",\"cat\":\""
+				<< event.category << "\",\"ph\":\"X\",\"pid\":" << pid
+				<< ",\"tid\":" << tid << ",\"ts\":" << event.begin / 1000
+				<< "." << event.begin / 100 % 10 << ",\"dur\":"
+				<< event.duration / 1000 << "." << event.duration / 100 % 10
+				<< ",\"args\":{";
+
+		const char *separator = "";
+		if (event.generation >= 0) {
+			ofs << "\"generation\":" << event.generation;
+			separator = ",";
+		}
+		if (event.individual >= 0) {
+			ofs << separator << "\"individual\":" << event.individual;
+			separator = ",";
+		}
+		if (event.active_nodes >= 0) {
+			ofs << separator << "\"active_nodes\":" << event.active_nodes;
+		}
+
+		ofs << "}}";
+	}
+
+public:
+	Tracer() {
+		this->reset();
+	}
+
+	/// @brief Discards the recorded spans and restarts the time base, e.g. at the start of a job.
+	/// @details The threads register new buffers with their next span.
+	void reset() {
+		std::lock_guard<std::mutex> lock(this->mtx);
+		this->id = next_id++;
+		this->buffers.clear();
+		this->start = std::chrono::steady_clock::now();
+	}
+
+	/// @brief Writes the recorded spans to a JSON file in the Chrome trace event format.
+	/// @details Must not be called while spans are recorded. The number of spans that
+	/// have been overwritten is stored in the metadata of the file.
+	/// @param path path of the file, missing directories are created
+	/// @param job job number that is used as the process id
+	void write(const std::string &path, int job) {
+		std::lock_guard<std::mutex> lock(this->mtx);
+
+		std::filesystem::path file(path);
+		if (file.has_parent_path()) {
+			std::filesystem::create_directories(file.parent_path());
+		}
+
+		std::ofstream ofs(path, std::ofstream::out | std::ofstream::trunc);
+		if (!ofs.is_open()) {
+			throw std::runtime_error("Could not open trace file " + path);
+		}
+
+		std::uint64_t dropped = 0;
+
+		ofs << "{\"traceEvents\":[";
+		ofs << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << job
+				<< ",\"args\":{\"name\":\"Job " << job << "\"}}";
+
+		for (std::size_t tid = 0; tid < this->buffers.size(); tid++) {
+			const Buffer &b = *this->buffers.at(tid);
+			std::uint64_t head = b.head.load(std::memory_order_acquire);
+
+			if (head > BUFFER_SIZE) {
+				dropped += head - BUFFER_SIZE;
+			}
+
+			ofs << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << job
+					<< ",\"tid\":" << tid << ",\"args\":{\"name\":\"Thread "
+					<< tid << "\"}}";
+
+			for (const Event &event : b.events) {
+				ofs << ",\n";
+				write_event(ofs, event, job, tid);
+			}
+		}
+
+		ofs << "],\n\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":"
+				<< dropped << "}}" << std::endl;
+	}
+};
+
+#endif /* PROFILING_TRACER_H_ */
@@ -10,6 +10,8 @@
 //	License: Academic Free License v. 3.0
 // ================================================================================
 
+#include <sstream>
+
 #include "Random.h"
 
 /// @brief Constructor to set the global seed. 
@@ -85,3 +87,42 @@ void Random::set_random_seed() {
 long long Random::get_global_seed() const {
 	return this->global_seed;
 }
+
+/// @brief Returns the internal state of the random generator. 
+/// @details Together with set_state, the generator can be continued exactly 
+/// where it has been stopped, e.g. when a job is resumed from a checkpoint.
+/// @return textual representation of the mt19937 state
+std::string Random::get_state() const {
+	std::stringstream ss;
+	ss << this->rng;
+	return ss.str();
+}
+
+/// @brief Restores the internal state of the random generator.
+/// @param p_state textual representation of the mt19937 state
+void Random::set_state(const std::string &p_state) {
+	std::stringstream ss(p_state);
+	ss >> this->rng;
+
+	if (ss.fail()) {
+		throw std::invalid_argument("Invalid state of the random generator!");
+	}
+}
+
+/// @brief Derives a deterministic seed for an independent random stream.
+/// @details Mixes the base seed and the stream number with the SplitMix64 finalizer
+/// so that neighbouring streams (e.g. job 1 and job 2) obtain uncorrelated seeds.
+/// The result is always positive and greater than zero.
+/// @param p_base_seed base (global) seed
+/// @param p_stream number of the stream
+/// @return seed of the stream
+long long Random::derive_seed(long long p_base_seed, int p_stream) {
+	uint64_t z = static_cast<uint64_t>(p_base_seed)
+			+ static_cast<uint64_t>(p_stream) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+
+	long long seed = static_cast<long long>(z & 0x7FFFFFFFFFFFFFFFULL);
+	return seed > 0 ? seed : 1;
+}
@@ -19,6 +19,7 @@
 #include <iostream>
 #include <chrono>
 #include <memory>
+#include <string>
 
 #include "../parameters/Parameters.h"
 
@@ -46,6 +47,11 @@ public:
 	void set_seed(long long p_global_seed);
 	void set_random_seed();
 	long long get_global_seed() const;
+
+	std::string get_state() const;
+	void set_state(const std::string &p_state);
+
+	static long long derive_seed(long long p_base_seed, int p_stream);
 };
 
 
@@ -101,6 +101,8 @@ template<class G, class F>
 void Recombination<G, F>::crossover(std::shared_ptr<Individual<G, F>> p1,
 		std::shared_ptr<Individual<G, F>> p2) {
 	this->op->variate(p1, p2);
+	p1->set_decoded(false);
+	p2->set_decoded(false);
 }
 
 /// @brief Print the recobination name. 
@@ -33,6 +33,7 @@ private:
 
 	F fitness;
 	bool evaluated = false;
+	bool decoded = false;
 public:
 	Individual(std::shared_ptr<Random> p_random,
 			std::shared_ptr<Parameters> p_parameters);
@@ -59,7 +60,10 @@ public:
 	void set_fitness(F p_fitness);
 	bool is_evaluated() const;
 	void set_evaluated(bool p_evaluated);
+	bool is_decoded() const;
+	void set_decoded(bool p_decoded);
 
+	void set_genome(std::shared_ptr<G[]> p_genome) override;
 	void copy_genome(std::shared_ptr<G[]> p_genome);
 
 	const std::string to_string(std::string delimiter=" ") const;
@@ -104,6 +108,7 @@ Individual<G,F>::Individual(std::shared_ptr<Individual<G, F>> individual) :
 
 	this->active_nodes =  std::make_shared<std::vector<int>>(*individual->active_nodes);
 	this->expressions = std::make_shared<std::vector<std::string>>(*individual->expressions);
+	this->decoded = individual->decoded;
 }
 
 /// @brief Returns a random integer in a open interval 
@@ -123,6 +128,7 @@ void Individual<G,F>::reset() {
 	this->reset_genome();
 	this->active_nodes->clear();
 	this->evaluated = false;
+	this->decoded = false;
 }
 
 /// @brief Resets the genome according to the representation type 
@@ -142,6 +148,8 @@ void Individual<G,F>::reset_genome() {
 			this->genome[i] = this->random->random_float(0.0, 1.0);
 		}
 	}
+
+	this->decoded = false;
 }
 
 // Handling of the active node vector 
@@ -208,6 +216,14 @@ const std::string Individual<G, F>::to_string(std::string delimiter) const {
 	return ss.str();
 }
 
+/// @brief Sets the genome and invalidates the decoded active path
+/// @param p_genome shared pointer to genome array
+template<class G, class F>
+void Individual<G, F>::set_genome(std::shared_ptr<G[]> p_genome) {
+	Species<G>::set_genome(p_genome);
+	this->decoded = false;
+}
+
 /// @brief Copy the genome that has been passed to the function
 /// @param p_genome shared pointer to genome array
 template<class G, class F>
@@ -217,6 +233,7 @@ void Individual<G, F>::copy_genome(std::shared_ptr<G[]> p_genome) {
 
 	std::copy(p_genome.get(), p_genome.get() + this->genome_size, genome_copy.get());
 	this->genome = genome_copy;
+	this->decoded = false;
 }
 
 /// @brief Trigger deep cloning via copy constructor
@@ -258,6 +275,16 @@ void Individual<G, F>::set_evaluated(bool p_evaluated) {
 	this->evaluated = p_evaluated;
 }
 
+template<class G, class F>
+bool Individual<G, F>::is_decoded() const {
+	return decoded;
+}
+
+template<class G, class F>
+void Individual<G, F>::set_decoded(bool p_decoded) {
+	this->decoded = p_decoded;
+}
+
 template<class G, class F>
 const std::shared_ptr<std::vector<int> >& Individual<G, F>::get_active_nodes() const {
 	return active_nodes;
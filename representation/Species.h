@@ -68,7 +68,8 @@ public:
 	std::unique_ptr<int[]> float_to_int();
 
 	std::shared_ptr<G[]> get_genome() const;
-	void set_genome(std::shared_ptr<G[]> genome);
+	virtual void set_genome(std::shared_ptr<G[]> genome);
+	int get_genome_size() const;
 
 	bool is_real_valued() const;
 
@@ -264,6 +265,11 @@ void Species<G>::set_genome(std::shared_ptr<G[]> genome) {
 	this->genome = genome;
 }
 
+template<class G>
+int Species<G>::get_genome_size() const {
+	return genome_size;
+}
+
 template<class G>
 bool Species<G>::is_real_valued() const {
 	return real_valued;
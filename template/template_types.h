@@ -1,3 +1,9 @@
+#ifdef CGP_SYMBOLIC_REGRESSION
+typedef float EVALUATION_TYPE;
+typedef int GENOME_TYPE;
+typedef float FITNESS_TYPE;
+#else
 typedef long EVALUATION_TYPE;
 typedef int GENOME_TYPE;
 typedef int FITNESS_TYPE;
+#endif